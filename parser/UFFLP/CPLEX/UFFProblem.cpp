@@ -238,6 +238,7 @@ UFFProblem::UFFProblem()
    userCutFunc = NULL;
    generatingCuts = false;
    userHeurFunc = NULL;
+   callBackData = NULL;
    inHeuristic = false;
    userIntChkFunc = NULL;
    checkingSolution = false;
@@ -89,6 +89,12 @@ public:
    // relaxation-based primal heuristics
    UFFLP_ErrorType setHeurCallBack(UFFLP_CallBackFunction heurFunc);
 
+   // Set and get the pointer to the user's data passed to the callbacks
+   inline void setCallBackData(void* data)
+   { callBackData = data; };
+   inline void* getCallBackData() const
+   { return callBackData; };
+
    // Get the current value of the best integer solution found (only allowed in
    // a heuristic callback).
    UFFLP_ErrorType getBestSolutionValue(double* value);
@@ -161,7 +167,9 @@ private:
    // Map of variable (column) names to column coefficients
    std::map<std::string,Constraint> varCoeffMap;
 
-   // Pointer to the solver environment
+   // Pointer to the solver environment (shared by all the problems, together
+   // with envCount and the CPLEX parameters, so problems of this version must
+   // not be used concurrently by different threads)
    static CPXENVptr env;
 
    // number of instances of this class using the environment
@@ -232,6 +240,9 @@ private:
    // User's primal heuristic function
    UFFLP_CallBackFunction userHeurFunc;
 
+   // User's data for the callbacks (see setCallBackData)
+   void* callBackData;
+
    // User's function to check whether an integer solutin is valid
    UFFLP_CallBackFunction userIntChkFunc;
 
@@ -0,0 +1,319 @@
+/****************************************************************************
+* An Example Program for...
+* UFFLP - An easy API for Mixed, Integer and Linear Programming
+*
+* Solves independent instances of the Maximum Independent Set Problem at the
+* same time on several threads, each with its own cut generation and primal
+* heuristic callbacks, and checks every result against a sequential solve.
+* It is a stress test for the concurrent use of different problems. It has
+* not been run yet against Cbc 2.4, so UFFLP makes no thread-safety promise
+* until it passes there.
+*
+*****************************************************************************/
+
+#include "../UFFLP.h"
+
+#include <sstream>
+#include <string>
+#include <iostream>
+#include <fstream>
+#include <vector>
+#include <algorithm>
+#include <thread>
+#include <stdlib.h>
+#include <math.h>
+
+//============== GLOBAL VARIABLES (read only while solving) ============
+int n;   // number of vertices
+int m;   // number of edges
+
+// Adjacency lists of the graph
+std::vector< std::vector<int> > neighbors;
+
+//============== PER-THREAD VARIABLES ============
+// The callbacks of a problem run in the thread that solves it, so these
+// counters are only touched by the thread that owns the problem
+thread_local int cutCalls = 0;
+thread_local int heurCalls = 0;
+
+// Result of the solves made by one thread
+struct ThreadResult
+{
+   int solves;       // number of solves made
+   int failures;     // number of solves with a wrong result
+   int cutCalls;     // calls to the cut generation callback
+   int heurCalls;    // calls to the primal heuristic callback
+};
+
+// ReadInputFile: Reads an input text file containing an instance of the
+//                Maximum Independent Set Problem.
+// @param fileName  Name of the input file
+bool ReadInputFile( char* fileName )
+{
+   // try to open the input file
+   std::ifstream f;
+   f.open( fileName, std::ifstream::in );
+   if ( f.fail() )
+   {
+      std::cout << "Fail to open file " << fileName << " for reading";
+      std::cout << std::endl;
+      return false;
+   }
+
+   // read the number of vertices and edges
+   f >> n;
+   f >> m;
+
+   // read the edges
+   neighbors.assign( n, std::vector<int>() );
+   int i, j, e;
+   for (e = 0; e < m; e++)
+   {
+      f >> i;
+      f >> j;
+      neighbors[i-1].push_back( j-1 );
+      neighbors[j-1].push_back( i-1 );
+   }
+
+   // close the input file
+   f.close();
+   return true;
+}
+
+// Compares vertices by decreasing value in the current solution
+struct ByValue
+{
+   const std::vector<double>* x;
+   bool operator()( int i, int j ) const
+   {
+      return ((*x)[i] > (*x)[j]) || (((*x)[i] == (*x)[j]) && (i < j));
+   }
+};
+
+// CliqueCuts: Generate cuts "sum of x_i <= 1" over cliques greedily grown
+//             from the vertices with fractional values
+// @param prob  Pointer to the problem
+void STDCALL CliqueCuts( UFFProblem* prob )
+{
+   cutCalls++;
+
+   // get the values of the variables in the current solution
+   std::vector<double> x( n );
+   if (UFFLP_GetSolutionVector( prob, &x[0], n ) != UFFLP_Ok) return;
+
+   std::vector<int> order( n );
+   for (int i = 0; i < n; i++) order[i] = i;
+   ByValue byValue;
+   byValue.x = &x;
+   std::sort( order.begin(), order.end(), byValue );
+
+   for (int k = 0; k < n; k++)
+   {
+      int v = order[k];
+      if ((x[v] < 0.01) || (x[v] > 0.99)) continue;
+
+      // grow a clique containing "v", always taking the largest value among
+      // the vertices adjacent to all the clique members
+      std::vector<int> clique( 1, v );
+      double sum = x[v];
+      std::vector<char> common( n, 0 );
+      for (int a = 0; a < (int)neighbors[v].size(); a++)
+         common[neighbors[v][a]] = 1;
+      for (int l = 0; l < n; l++)
+      {
+         int u = order[l];
+         if (!common[u] || (x[u] < 0.01)) continue;
+         clique.push_back( u );
+         sum += x[u];
+
+         // keep only the common neighbors of "u" as candidates
+         std::vector<char> adjacent( n, 0 );
+         for (int a = 0; a < (int)neighbors[u].size(); a++)
+            adjacent[neighbors[u][a]] = 1;
+         for (int w = 0; w < n; w++)
+            common[w] = common[w] && adjacent[w];
+      }
+
+      // -> NEVER insert a cut when the violation is too small
+      if (sum > 1.01)
+      {
+         std::vector<double> coeffs( clique.size(), 1.0 );
+         UFFLP_AddRowIdx( prob, NULL, (int)clique.size(), &clique[0],
+               &coeffs[0], 1.0, UFFLP_Less, NULL );
+      }
+   }
+}
+
+// GreedyHeuristic: Build an independent set taking the vertices in decreasing
+//                  order of value in the current solution
+// @param prob  Pointer to the problem
+void STDCALL GreedyHeuristic( UFFProblem* prob )
+{
+   heurCalls++;
+
+   std::vector<double> x( n );
+   if (UFFLP_GetSolutionVector( prob, &x[0], n ) != UFFLP_Ok) return;
+
+   std::vector<int> order( n );
+   for (int i = 0; i < n; i++) order[i] = i;
+   ByValue byValue;
+   byValue.x = &x;
+   std::sort( order.begin(), order.end(), byValue );
+
+   // send the integer solution to the solver
+   std::vector<char> blocked( n, 0 );
+   for (int k = 0; k < n; k++)
+   {
+      int v = order[k];
+      if (blocked[v]) continue;
+      UFFLP_SetSolutionIdx( prob, v, 1.0 );
+      for (int a = 0; a < (int)neighbors[v].size(); a++)
+         blocked[neighbors[v][a]] = 1;
+   }
+}
+
+// SolveInstance: Build and solve the problem, writing the files with the
+//                given name
+// @param name      Name used for the LP and log files
+// @param objValue  Where the objective function value is stored
+// @return true if an optimal independent set has been found
+bool SolveInstance( const std::string& name, double* objValue )
+{
+   // create an empty problem instance
+   UFFProblem* prob = UFFLP_CreateProblem();
+
+   // create one binary variable "x_i" for each vertex
+   int i;
+   for (i = 0; i < n; i++)
+   {
+      std::stringstream s;
+      s << "x_" << i+1;
+      UFFLP_AddVariableIdx( prob, (char*)s.str().c_str(), 0.0, 1.0, 1.0,
+            UFFLP_Binary, NULL );
+   }
+
+   // create one constraint "x_i + x_j <= 1" for each edge
+   int ind[2];
+   double coeffs[2] = { 1.0, 1.0 };
+   for (i = 0; i < n; i++)
+   {
+      for (int a = 0; a < (int)neighbors[i].size(); a++)
+      {
+         if (neighbors[i][a] < i) continue;
+         ind[0] = i;
+         ind[1] = neighbors[i][a];
+         UFFLP_AddRowIdx( prob, NULL, 2, ind, coeffs, 1.0, UFFLP_Less, NULL );
+      }
+   }
+
+   // each concurrent problem writes its own files
+   UFFLP_WriteLP( prob, (char*)(name + ".lp").c_str() );
+   UFFLP_SetLogInfo( prob, (char*)(name + ".log").c_str(), 1 );
+
+   // set the callbacks
+   UFFLP_SetCutCallBack( prob, CliqueCuts );
+   UFFLP_SetHeurCallBack( prob, GreedyHeuristic );
+
+   // solve the problem
+   UFFLP_StatusType status = UFFLP_Solve( prob, UFFLP_Maximize );
+   bool ok = (status == UFFLP_Optimal);
+
+   // check that the solution is an independent set with the reported value
+   if (ok)
+   {
+      std::vector<double> x( n );
+      UFFLP_GetObjValue( prob, objValue );
+      UFFLP_GetSolutionVector( prob, &x[0], n );
+      double size = 0.0;
+      for (i = 0; i < n; i++)
+      {
+         if (x[i] < 0.5) continue;
+         size += 1.0;
+         for (int a = 0; a < (int)neighbors[i].size(); a++)
+            if (x[neighbors[i][a]] > 0.5) ok = false;
+      }
+      if (fabs(size - *objValue) > 1e-6) ok = false;
+   }
+
+   // destroy the problem instance
+   UFFLP_DestroyProblem( prob );
+   return ok;
+}
+
+// RunThread: Solve the instance several times and compare each result with
+//            the sequential one
+void RunThread( int t, int rounds, double expected, ThreadResult* result )
+{
+   result->solves = result->failures = 0;
+   for (int r = 0; r < rounds; r++)
+   {
+      std::stringstream s;
+      s << "Concurrent_" << t;
+      double value = -1.0;
+      bool ok = SolveInstance( s.str(), &value );
+      result->solves++;
+      if (!ok || (fabs(value - expected) > 1e-6)) result->failures++;
+   }
+   result->cutCalls = cutCalls;
+   result->heurCalls = heurCalls;
+}
+
+int main( int argc, char* argv[] )
+{
+   // check the programs argument
+   if ((argc < 2) || (argc > 4))
+   {
+      std::cout << "Use: Concurrent.exe <filename> [threads] [rounds]"
+            << std::endl;
+      return 1;
+   }
+   int threads = (argc > 2)? atoi( argv[2] ): 8;
+   int rounds = (argc > 3)? atoi( argv[3] ): 4;
+   if ((threads < 1) || (rounds < 1))
+   {
+      std::cout << "The number of threads and rounds must be positive"
+            << std::endl;
+      return 1;
+   }
+
+   // read the input file
+   if ( !ReadInputFile(argv[1]) )
+      return 2;
+
+   // solve once without concurrency to get the expected value
+   double expected;
+   if ( !SolveInstance( "Concurrent_seq", &expected ) )
+   {
+      std::cout << "The sequential solve failed" << std::endl;
+      return 3;
+   }
+   std::cout << "Sequential optimum = " << expected << std::endl;
+
+   // solve the same instance on all the threads at the same time
+   std::vector<ThreadResult> results( threads );
+   std::vector<std::thread> pool;
+   for (int t = 0; t < threads; t++)
+      pool.push_back( std::thread( RunThread, t, rounds, expected,
+            &results[t] ) );
+   for (int t = 0; t < threads; t++)
+      pool[t].join();
+
+   // report the results
+   int failures = 0;
+   for (int t = 0; t < threads; t++)
+   {
+      std::cout << "Thread " << t << ": " << results[t].solves << " solves, "
+            << results[t].failures << " wrong, " << results[t].cutCalls
+            << " cut calls, " << results[t].heurCalls << " heuristic calls"
+            << std::endl;
+      failures += results[t].failures;
+   }
+   if (failures > 0)
+   {
+      std::cout << "FAILED: " << failures << " wrong results" << std::endl;
+      return 4;
+   }
+   std::cout << "OK" << std::endl;
+
+	return 0;
+}
@@ -0,0 +1,201 @@
+/****************************************************************************
+* An Example Program for...
+* UFFLP - An easy API for Mixed, Integer and Linear Programming
+*
+* Solves a weighted Maximum Independent Set Problem several times on the same
+* problem instance, changing the variable bounds and the objective function
+* between the solves, and compares each result with the one of a fresh
+* problem built with the same bounds and objective. It checks that nothing
+* left by a previous branch-and-bound (e.g. bounds fixed by reduced cost)
+* changes the result of the next solve.
+*
+*****************************************************************************/
+
+#include "../UFFLP.h"
+
+#include <sstream>
+#include <string>
+#include <iostream>
+#include <fstream>
+#include <vector>
+#include <stdlib.h>
+#include <math.h>
+
+//============== GLOBAL VARIABLES (use with caution) ============
+int n;   // number of vertices
+int m;   // number of edges
+
+// Edges of the graph
+std::vector<int> edgeFrom;
+std::vector<int> edgeTo;
+
+// Current weights and bounds of the vertices
+std::vector<double> weight;
+std::vector<double> lower;
+std::vector<double> upper;
+
+// ReadInputFile: Reads an input text file containing an instance of the
+//                Maximum Independent Set Problem.
+// @param fileName  Name of the input file
+bool ReadInputFile( char* fileName )
+{
+   // try to open the input file
+   std::ifstream f;
+   f.open( fileName, std::ifstream::in );
+   if ( f.fail() )
+   {
+      std::cout << "Fail to open file " << fileName << " for reading";
+      std::cout << std::endl;
+      return false;
+   }
+
+   // read the number of vertices and edges
+   f >> n;
+   f >> m;
+
+   // read the edges
+   edgeFrom.resize( m );
+   edgeTo.resize( m );
+   for (int e = 0; e < m; e++)
+   {
+      f >> edgeFrom[e];
+      f >> edgeTo[e];
+      edgeFrom[e]--;
+      edgeTo[e]--;
+   }
+
+   // close the input file
+   f.close();
+   return true;
+}
+
+// BuildProblem: Create a problem with the current weights and bounds
+// @return Pointer to the new problem
+UFFProblem* BuildProblem()
+{
+   // create an empty problem instance
+   UFFProblem* prob = UFFLP_CreateProblem();
+
+   // create one binary variable "x_i" for each vertex
+   int i;
+   for (i = 0; i < n; i++)
+   {
+      std::stringstream s;
+      s << "x_" << i+1;
+      UFFLP_AddVariableIdx( prob, (char*)s.str().c_str(), lower[i], upper[i],
+            weight[i], UFFLP_Binary, NULL );
+   }
+
+   // create one constraint "x_i + x_j <= 1" for each edge
+   int ind[2];
+   double coeffs[2] = { 1.0, 1.0 };
+   for (int e = 0; e < m; e++)
+   {
+      ind[0] = edgeFrom[e];
+      ind[1] = edgeTo[e];
+      UFFLP_AddRowIdx( prob, NULL, 2, ind, coeffs, 1.0, UFFLP_Less, NULL );
+   }
+
+   return prob;
+}
+
+// SolveAndCheck: Solve the problem and check that the solution is an
+//                independent set within the current bounds
+// @param prob      Pointer to the problem
+// @param objValue  Where the objective function value is stored
+// @return true if an optimal and valid solution has been found
+bool SolveAndCheck( UFFProblem* prob, double* objValue )
+{
+   if (UFFLP_Solve( prob, UFFLP_Maximize ) != UFFLP_Optimal)
+      return false;
+
+   std::vector<double> x( n );
+   UFFLP_GetObjValue( prob, objValue );
+   UFFLP_GetSolutionVector( prob, &x[0], n );
+   double value = 0.0;
+   for (int i = 0; i < n; i++)
+   {
+      if ((x[i] < lower[i] - 1e-6) || (x[i] > upper[i] + 1e-6)) return false;
+      value += weight[i] * x[i];
+   }
+   for (int e = 0; e < m; e++)
+      if (x[edgeFrom[e]] + x[edgeTo[e]] > 1.0 + 1e-6) return false;
+   return fabs(value - *objValue) < 1e-6;
+}
+
+// NewRound: Draw new weights and a new set of vertices fixed at zero, and
+//           apply them to the problem
+// @param prob   Pointer to the problem
+// @param round  Number of the round (also used as the fixing pattern)
+void NewRound( UFFProblem* prob, int round )
+{
+   for (int i = 0; i < n; i++)
+   {
+      weight[i] = 1.0 + (rand() % 10);
+      UFFLP_ChangeObjCoeffIdx( prob, i, weight[i] );
+
+      // each round fixes a different third of the vertices at zero and frees
+      // the ones fixed by the previous round
+      lower[i] = 0.0;
+      upper[i] = ((i + round) % 3 == 0)? 0.0: 1.0;
+      UFFLP_ChangeBoundsIdx( prob, i, lower[i], upper[i] );
+   }
+}
+
+int main( int argc, char* argv[] )
+{
+   // check the programs argument
+   if ((argc < 2) || (argc > 3))
+   {
+      std::cout << "Use: Resolve.exe <filename> [rounds]" << std::endl;
+      return 1;
+   }
+   int rounds = (argc > 2)? atoi( argv[2] ): 6;
+   if (rounds < 1)
+   {
+      std::cout << "The number of rounds must be positive" << std::endl;
+      return 1;
+   }
+
+   // read the input file
+   if ( !ReadInputFile(argv[1]) )
+      return 2;
+
+   // start with unit weights and no fixed vertex
+   srand( 1 );
+   weight.assign( n, 1.0 );
+   lower.assign( n, 0.0 );
+   upper.assign( n, 1.0 );
+   UFFProblem* prob = BuildProblem();
+
+   int failures = 0;
+   for (int r = 0; r <= rounds; r++)
+   {
+      // change the bounds and the objective of the problem already solved
+      if (r > 0) NewRound( prob, r );
+
+      // solve it again and solve a fresh problem with the same data
+      double reused = -1.0, fresh = -2.0;
+      bool reusedOk = SolveAndCheck( prob, &reused );
+      UFFProblem* freshProb = BuildProblem();
+      bool freshOk = SolveAndCheck( freshProb, &fresh );
+      UFFLP_DestroyProblem( freshProb );
+
+      bool ok = reusedOk && freshOk && (fabs(reused - fresh) < 1e-6);
+      std::cout << "Round " << r << ": re-solved = " << reused
+            << ", fresh = " << fresh << (ok? "": "  <- WRONG") << std::endl;
+      if (!ok) failures++;
+   }
+
+   // destroy the problem instance
+   UFFLP_DestroyProblem( prob );
+
+   if (failures > 0)
+   {
+      std::cout << "FAILED: " << failures << " wrong results" << std::endl;
+      return 4;
+   }
+   std::cout << "OK" << std::endl;
+
+	return 0;
+}
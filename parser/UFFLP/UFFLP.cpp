@@ -76,6 +76,16 @@ UFFLP_ErrorType CPP_UFFLP_AddVariable(UFFProblem* prob, char* name,
    return prob->addVariable( name, lb, ub, obj, type );
 }
 
+UFFLP_ErrorType CPP_UFFLP_AddVariableIdx(UFFProblem* prob, char* name,
+      double lb, double ub, double obj, UFFLP_VarType type, int* idx)
+{
+#ifdef USE_CPLEX
+   return UFFLP_NotSupported;
+#else
+   return prob->addVariable( name, lb, ub, obj, type, idx );
+#endif
+}
+
 UFFLP_ErrorType CPP_UFFLP_SetCoefficient(UFFProblem* prob,
       char* cname, char* vname, double value)
 {
@@ -88,6 +98,17 @@ UFFLP_ErrorType CPP_UFFLP_AddConstraint(UFFProblem* prob, char* name,
    return prob->addConstraint( name, rhs, type );
 }
 
+UFFLP_ErrorType CPP_UFFLP_AddRowIdx(UFFProblem* prob, char* name,
+      int nz, int* indices, double* coeffs, double rhs, UFFLP_ConsType type,
+      int* idx)
+{
+#ifdef USE_CPLEX
+   return UFFLP_NotSupported;
+#else
+   return prob->addRow( name, nz, indices, coeffs, rhs, type, idx );
+#endif
+}
+
 UFFLP_StatusType CPP_UFFLP_Solve(UFFProblem* prob, UFFLP_ObjSense sense)
 {
    return prob->solve( sense );
@@ -104,6 +125,36 @@ UFFLP_ErrorType CPP_UFFLP_GetSolution(UFFProblem* prob, char* vname,
    return prob->getSolution( vname, value );
 }
 
+UFFLP_ErrorType CPP_UFFLP_GetSolutionIdx(UFFProblem* prob, int vidx,
+      double* value)
+{
+#ifdef USE_CPLEX
+   return UFFLP_NotSupported;
+#else
+   return prob->getSolution( vidx, value );
+#endif
+}
+
+UFFLP_ErrorType CPP_UFFLP_GetSolutionVector(UFFProblem* prob, double* values,
+      int n)
+{
+#ifdef USE_CPLEX
+   return UFFLP_NotSupported;
+#else
+   return prob->getSolutionVector( values, n );
+#endif
+}
+
+UFFLP_ErrorType CPP_UFFLP_GetSolutionNonzeros(UFFProblem* prob, double toler,
+      int* indices, double* values, int n, int* nz)
+{
+#ifdef USE_CPLEX
+   return UFFLP_NotSupported;
+#else
+   return prob->getSolutionNonzeros( toler, indices, values, n, nz );
+#endif
+}
+
 UFFLP_ErrorType CPP_UFFLP_GetDualSolution(UFFProblem* prob, char* cname,
       double* value)
 {
@@ -137,6 +188,18 @@ UFFLP_ErrorType CPP_UFFLP_SetHeurCallBack(UFFProblem* prob,
    return prob->setHeurCallBack( heurFunc );
 }
 
+UFFLP_ErrorType CPP_UFFLP_SetCallBackData(UFFProblem* prob, void* data)
+{
+   prob->setCallBackData( data );
+   return UFFLP_Ok;
+}
+
+UFFLP_ErrorType CPP_UFFLP_GetCallBackData(UFFProblem* prob, void** data)
+{
+   *data = prob->getCallBackData();
+   return UFFLP_Ok;
+}
+
 UFFLP_ErrorType CPP_UFFLP_GetBestSolutionValue(UFFProblem* prob,
       double* value)
 {
@@ -149,6 +212,26 @@ UFFLP_ErrorType CPP_UFFLP_SetSolution(UFFProblem* prob, char* vname,
    return prob->setSolution( vname, value );
 }
 
+UFFLP_ErrorType CPP_UFFLP_SetSolutionIdx(UFFProblem* prob, int vidx,
+      double value)
+{
+#ifdef USE_CPLEX
+   return UFFLP_NotSupported;
+#else
+   return prob->setSolution( vidx, value );
+#endif
+}
+
+UFFLP_ErrorType CPP_UFFLP_GetSolveInfo(UFFProblem* prob, UFFLP_InfoType info,
+      double* value)
+{
+#ifdef USE_CPLEX
+   return UFFLP_NotSupported;
+#else
+   return prob->getSolveInfo( info, value );
+#endif
+}
+
 UFFLP_ErrorType CPP_UFFLP_SetParameter(UFFProblem* prob,
       UFFLP_ParameterType param, double value)
 {
@@ -161,6 +244,16 @@ UFFLP_ErrorType CPP_UFFLP_ChangeObjCoeff(UFFProblem* prob, char* vname,
    return prob->changeObjCoeff( vname, value );
 }
 
+UFFLP_ErrorType CPP_UFFLP_ChangeObjCoeffIdx(UFFProblem* prob, int vidx,
+      double value)
+{
+#ifdef USE_CPLEX
+   return UFFLP_NotSupported;
+#else
+   return prob->changeObjCoeff( vidx, value );
+#endif
+}
+
 UFFLP_ErrorType CPP_UFFLP_SetPriority(UFFProblem* prob, char* vname,
       int prior)
 {
@@ -208,6 +301,26 @@ UFFLP_ErrorType CPP_UFFLP_ChangeBounds(UFFProblem* prob,
    return prob->changeBounds( vname, lb, ub );
 }
 
+UFFLP_ErrorType CPP_UFFLP_ChangeBoundsIdx(UFFProblem* prob,
+      int vidx, double lb, double ub)
+{
+#ifdef USE_CPLEX
+   return UFFLP_NotSupported;
+#else
+   return prob->changeBounds( vidx, lb, ub );
+#endif
+}
+
+UFFLP_ErrorType CPP_UFFLP_SetInitialSolution(UFFProblem* prob, int n,
+      double* values)
+{
+#ifdef USE_CPLEX
+   return UFFLP_NotSupported;
+#else
+   return prob->setInitialSolution( n, values );
+#endif
+}
+
 //===================================================================
 // EXPORTED ANSI C FUNCTIONS
 //===================================================================
@@ -230,6 +343,13 @@ UFFLP_API UFFLP_ErrorType STDCALL UFFLP_AddVariable(UFFProblem* prob,
    return CPP_UFFLP_AddVariable( prob, name, lb, ub, obj, type );
 }
 
+UFFLP_API UFFLP_ErrorType STDCALL UFFLP_AddVariableIdx(UFFProblem* prob,
+      char* name, double lb, double ub, double obj, UFFLP_VarType type,
+      int* idx)
+{
+   return CPP_UFFLP_AddVariableIdx( prob, name, lb, ub, obj, type, idx );
+}
+
 UFFLP_API UFFLP_ErrorType STDCALL UFFLP_SetCoefficient(UFFProblem* prob,
       char* cname, char* vname, double value)
 {
@@ -242,6 +362,14 @@ UFFLP_API UFFLP_ErrorType STDCALL UFFLP_AddConstraint(UFFProblem* prob,
    return CPP_UFFLP_AddConstraint( prob, name, rhs, type );
 }
 
+UFFLP_API UFFLP_ErrorType STDCALL UFFLP_AddRowIdx(UFFProblem* prob,
+      char* name, int nz, int* indices, double* coeffs, double rhs,
+      UFFLP_ConsType type, int* idx)
+{
+   return CPP_UFFLP_AddRowIdx( prob, name, nz, indices, coeffs, rhs, type,
+         idx );
+}
+
 UFFLP_API UFFLP_StatusType STDCALL UFFLP_Solve(UFFProblem* prob,
       UFFLP_ObjSense sense)
 {
@@ -260,6 +388,24 @@ UFFLP_API UFFLP_ErrorType STDCALL UFFLP_GetSolution(UFFProblem* prob,
    return CPP_UFFLP_GetSolution( prob, vname, value );
 }
 
+UFFLP_API UFFLP_ErrorType STDCALL UFFLP_GetSolutionIdx(UFFProblem* prob,
+      int vidx, double* value)
+{
+   return CPP_UFFLP_GetSolutionIdx( prob, vidx, value );
+}
+
+UFFLP_API UFFLP_ErrorType STDCALL UFFLP_GetSolutionVector(UFFProblem* prob,
+      double* values, int n)
+{
+   return CPP_UFFLP_GetSolutionVector( prob, values, n );
+}
+
+UFFLP_API UFFLP_ErrorType STDCALL UFFLP_GetSolutionNonzeros(UFFProblem* prob,
+      double toler, int* indices, double* values, int n, int* nz)
+{
+   return CPP_UFFLP_GetSolutionNonzeros( prob, toler, indices, values, n, nz );
+}
+
 UFFLP_API UFFLP_ErrorType STDCALL UFFLP_GetDualSolution(UFFProblem* prob,
       char* cname, double* value)
 {
@@ -296,6 +442,18 @@ UFFLP_API UFFLP_ErrorType STDCALL UFFLP_SetHeurCallBack(UFFProblem* prob,
    return CPP_UFFLP_SetHeurCallBack( prob, heurFunc );
 }
 
+UFFLP_API UFFLP_ErrorType STDCALL UFFLP_SetCallBackData(UFFProblem* prob,
+      void* data)
+{
+   return CPP_UFFLP_SetCallBackData( prob, data );
+}
+
+UFFLP_API UFFLP_ErrorType STDCALL UFFLP_GetCallBackData(UFFProblem* prob,
+      void** data)
+{
+   return CPP_UFFLP_GetCallBackData( prob, data );
+}
+
 UFFLP_API UFFLP_ErrorType STDCALL UFFLP_GetBestSolutionValue(
       UFFProblem* prob, double* value)
 {
@@ -308,6 +466,18 @@ UFFLP_API UFFLP_ErrorType STDCALL UFFLP_SetSolution(UFFProblem* prob,
    return CPP_UFFLP_SetSolution( prob, vname, value );
 }
 
+UFFLP_API UFFLP_ErrorType STDCALL UFFLP_SetSolutionIdx(UFFProblem* prob,
+      int vidx, double value)
+{
+   return CPP_UFFLP_SetSolutionIdx( prob, vidx, value );
+}
+
+UFFLP_API UFFLP_ErrorType STDCALL UFFLP_GetSolveInfo(UFFProblem* prob,
+      UFFLP_InfoType info, double* value)
+{
+   return CPP_UFFLP_GetSolveInfo( prob, info, value );
+}
+
 UFFLP_API UFFLP_ErrorType STDCALL UFFLP_SetParameter(UFFProblem* prob,
       UFFLP_ParameterType param, double value)
 {
@@ -320,6 +490,12 @@ UFFLP_API UFFLP_ErrorType STDCALL UFFLP_ChangeObjCoeff(UFFProblem* prob,
    return CPP_UFFLP_ChangeObjCoeff( prob, vname, value );
 }
 
+UFFLP_API UFFLP_ErrorType STDCALL UFFLP_ChangeObjCoeffIdx(UFFProblem* prob,
+      int vidx, double value)
+{
+   return CPP_UFFLP_ChangeObjCoeffIdx( prob, vidx, value );
+}
+
 UFFLP_API UFFLP_ErrorType STDCALL UFFLP_SetPriority(UFFProblem* prob,
       char* vname, int prior)
 {
@@ -355,4 +531,16 @@ UFFLP_API UFFLP_ErrorType STDCALL UFFLP_ChangeBounds(UFFProblem* prob,
    return CPP_UFFLP_ChangeBounds( prob, vname, lb, ub );
 }
 
+UFFLP_API UFFLP_ErrorType STDCALL UFFLP_ChangeBoundsIdx(UFFProblem* prob,
+      int vidx, double lb, double ub)
+{
+   return CPP_UFFLP_ChangeBoundsIdx( prob, vidx, lb, ub );
+}
+
+UFFLP_API UFFLP_ErrorType STDCALL UFFLP_SetInitialSolution(UFFProblem* prob,
+      int n, double* values)
+{
+   return CPP_UFFLP_SetInitialSolution( prob, n, values );
+}
+
 };
@@ -79,7 +79,9 @@ enum UFFLP_ErrorType
    UFFLP_InNonCutCallback, // operation in a callback is allowed only for cuts
    UFFLP_NotInIntCheck,    // operation is allowed only in an integer check
    UFFLP_NoSolExists,      // the current problem has no solution
-   UFFLP_UnknownVarType    // trying to add a variable of unknown type
+   UFFLP_UnknownVarType,   // trying to add a variable of unknown type
+   UFFLP_InvalidIndex,     // variable or constraint index out of range
+   UFFLP_NotSupported      // operation not supported by the current solver
 };
 
 enum UFFLP_StatusType
@@ -103,6 +105,27 @@ enum UFFLP_ParamTypeType
    UFFLP_FloatParam        // floating point parameter
 };
 
+enum UFFLP_InfoType
+{
+   UFFLP_NumRows,          // Number of constraints in the model
+   UFFLP_NumCols,          // Number of variables in the model
+   UFFLP_NumNonzeros,      // Number of nonzero constraint coefficients
+   UFFLP_NodeCount,        // B&B nodes explored by the last solve
+   UFFLP_IterationCount,   // LP iterations performed by the last solve
+   UFFLP_RelativeGap,      // Relative gap between incumbent and best bound
+   UFFLP_SyncTime,         // Seconds spent loading the model in the solver
+   UFFLP_OptimizeTime      // Seconds spent solving the relaxation and the B&B
+};
+
+// Note: The COIN/Cbc version keeps the UFFLP state of a problem in its
+// UFFProblem instance, and the callbacks of a problem run in the thread that
+// called UFFLP_Solve for it. This does NOT make concurrent solves safe: the
+// global state inside Cbc, Clp, Cgl and CoinUtils has not been checked, and
+// solving different problems on different threads at the same time has not
+// been tested (see Test/Concurrent.cpp). Solve problems from one thread at a
+// time, or use separate processes. The CPLEX version shares one environment
+// (and its parameters) among all the problems.
+
 // Bound value assumed to be infinity
 const double UFFLP_Infinity = 1E15;
 
@@ -136,6 +159,23 @@ UFFLP_API void STDCALL UFFLP_DestroyProblem(UFFProblem* prob);
 UFFLP_API UFFLP_ErrorType STDCALL UFFLP_AddVariable(UFFProblem* prob,
       char* name, double lb, double ub, double obj, UFFLP_VarType type);
 
+// Insert a new variable in the problem's model and get its index. Variables
+// are numbered 0, 1, 2, ... in the order they are inserted, either by this
+// function or by UFFLP_AddVariable, and the index can be passed to the other
+// "Idx" functions.
+// @param prob  pointer to the problem
+// @param name  variable's name, or NULL for an unnamed variable
+// @param lb    lower bound on the value of the new variable
+// @param ub    upper bound on the value of the new variable
+// @param obj   coefficent of the new variable in the objective function
+// @param type  variable type (continuous, integer, binary, ...)
+// @param idx   pointer to where the index of the new variable should be
+//              stored (may be NULL)
+// @return an error code or UFFLP_Ok if successful
+UFFLP_API UFFLP_ErrorType STDCALL UFFLP_AddVariableIdx(UFFProblem* prob,
+      char* name, double lb, double ub, double obj, UFFLP_VarType type,
+      int* idx);
+
 // Set a coefficient of a constraint before inserting it in the problem's
 // model.
 // @param prob  pointer to the problem
@@ -158,6 +198,24 @@ UFFLP_API UFFLP_ErrorType STDCALL UFFLP_SetCoefficient(UFFProblem* prob,
 UFFLP_API UFFLP_ErrorType STDCALL UFFLP_AddConstraint(UFFProblem* prob,
       char* name, double rhs, UFFLP_ConsType type);
 
+// Insert a constraint in the problem's model given all its coefficients at
+// once by variable index, without calling UFFLP_SetCoefficient. Repeated
+// indices are not checked. If the user code is inside the context of a cut
+// callback, then the constraint is inserted as a cut.
+// @param prob    pointer to the problem
+// @param name    constraint's name, or NULL for an unnamed constraint
+// @param nz      number of coefficients
+// @param indices indices of the variables with nonzero coefficients
+// @param coeffs  values of the coefficients
+// @param rhs     right-hand side of the constraint
+// @param type    constraint type (less, equal, or greater)
+// @param idx     pointer to where the index of the new constraint should be
+//                stored (may be NULL; cuts get -1)
+// @return an error code or UFFLP_Ok if successful
+UFFLP_API UFFLP_ErrorType STDCALL UFFLP_AddRowIdx(UFFProblem* prob,
+      char* name, int nz, int* indices, double* coeffs, double rhs,
+      UFFLP_ConsType type, int* idx);
+
 // Solve the problem
 // @param prob  pointer to the problem
 // @param sense objetive function sense (maximize or minimize)
@@ -182,6 +240,37 @@ UFFLP_API UFFLP_ErrorType STDCALL UFFLP_GetObjValue(UFFProblem* prob,
 UFFLP_API UFFLP_ErrorType STDCALL UFFLP_GetSolution(UFFProblem* prob,
       char* vname, double* value);
 
+// Get the value of a variable, given by its index, in the current solution.
+// Inside a callback, the values for the current LP relaxation are returned.
+// @param prob  pointer to the problem
+// @param vidx  index of the variable
+// @param value pointer to where the value should be stored
+// @return an error code or UFFLP_Ok if successful
+UFFLP_API UFFLP_ErrorType STDCALL UFFLP_GetSolutionIdx(UFFProblem* prob,
+      int vidx, double* value);
+
+// Get the values of the first n variables in the current solution at once.
+// Inside a callback, the values for the current LP relaxation are returned.
+// @param prob   pointer to the problem
+// @param values array of at least n positions where the values are stored
+// @param n      number of variables to get (at most the number of variables)
+// @return an error code or UFFLP_Ok if successful
+UFFLP_API UFFLP_ErrorType STDCALL UFFLP_GetSolutionVector(UFFProblem* prob,
+      double* values, int n);
+
+// Get the variables whose absolute values in the current solution are greater
+// than a tolerance, in increasing order of index. At most n of them are stored,
+// but the total number of such variables is always returned in nz.
+// @param prob    pointer to the problem
+// @param toler   values whose absolute values do not exceed toler are skipped
+// @param indices array of at least n positions for the variable indices
+// @param values  array of at least n positions for the variable values
+// @param n       maximum number of variables to store
+// @param nz      pointer to where the number of such variables is stored
+// @return an error code or UFFLP_Ok if successful
+UFFLP_API UFFLP_ErrorType STDCALL UFFLP_GetSolutionNonzeros(UFFProblem* prob,
+      double toler, int* indices, double* values, int n, int* nz);
+
 // Get the value of a dual variable in the current solution. Cannot be called
 // inside a callback.
 // @param prob  pointer to the problem
@@ -227,6 +316,21 @@ UFFLP_API UFFLP_ErrorType STDCALL UFFLP_PrintToLog(UFFProblem* prob,
 UFFLP_API UFFLP_ErrorType STDCALL UFFLP_SetHeurCallBack(UFFProblem* prob,
       UFFLP_CallBackFunction heurFunc);
 
+// Set a pointer to the user's data, which the callbacks of the problem may
+// get through UFFLP_GetCallBackData instead of reading global variables.
+// @param prob  pointer to the problem
+// @param data  pointer to the user's data (may be NULL)
+// @return an error code or UFFLP_Ok if successful
+UFFLP_API UFFLP_ErrorType STDCALL UFFLP_SetCallBackData(UFFProblem* prob,
+      void* data);
+
+// Get the pointer set by UFFLP_SetCallBackData (NULL if none has been set).
+// @param prob  pointer to the problem
+// @param data  pointer to where the user's data pointer should be stored
+// @return an error code or UFFLP_Ok if successful
+UFFLP_API UFFLP_ErrorType STDCALL UFFLP_GetCallBackData(UFFProblem* prob,
+      void** data);
+
 // Get the current value of the best integer solution found (only allowed in
 // a heuristic callback).
 // @param prob  pointer to the problem
@@ -245,6 +349,25 @@ UFFLP_API UFFLP_ErrorType STDCALL UFFLP_GetBestSolutionValue(
 UFFLP_API UFFLP_ErrorType STDCALL UFFLP_SetSolution(UFFProblem* prob,
       char* vname, double value);
 
+// Set the value of a variable, given by its index, in the integer solution
+// provided by the user (only allowed in a heuristic callback).
+// @param prob  pointer to the problem
+// @param vidx  index of the variable
+// @param value value of the variable in the provided solution
+// @return an error code or UFFLP_Ok if successful
+UFFLP_API UFFLP_ErrorType STDCALL UFFLP_SetSolutionIdx(UFFProblem* prob,
+      int vidx, double value);
+
+// Get a statistic of the model or of the last call to UFFLP_Solve, such as
+// its size, the number of B&B nodes or the time spent in each phase. The
+// times are wall-clock seconds. Do not call it inside a callback.
+// @param prob  pointer to the problem
+// @param info  statistic to be retrieved
+// @param value pointer to where the value shall be stored
+// @return an error code or UFFLP_Ok if successful
+UFFLP_API UFFLP_ErrorType STDCALL UFFLP_GetSolveInfo(UFFProblem* prob,
+      UFFLP_InfoType info, double* value);
+
 // Set the value for a solver parameter. Both integer and floating point
 // parameters are set through this function. For integer parameters, the value
 // is truncated.
@@ -264,6 +387,16 @@ UFFLP_API UFFLP_ErrorType STDCALL UFFLP_SetParameter(UFFProblem* prob,
 UFFLP_API UFFLP_ErrorType STDCALL UFFLP_ChangeObjCoeff(UFFProblem* prob,
       char* vname, double value);
 
+// Change the coefficient of a variable, given by its index, in the objective
+// function. The problem can be solved again after that. Do not call it inside
+// a callback.
+// @param prob  pointer to the problem
+// @param vidx  index of the variable
+// @param value new value of the coefficient
+// @return an error code or UFFLP_Ok if successful
+UFFLP_API UFFLP_ErrorType STDCALL UFFLP_ChangeObjCoeffIdx(UFFProblem* prob,
+      int vidx, double value);
+
 // Set the branching priority of a variable (CPLEX only, ignored by COIN-OR).
 // Variables with higher priorities are preferred. By default, variables receive
 // priority zero.
@@ -321,6 +454,28 @@ UFFLP_API UFFLP_ErrorType STDCALL UFFLP_SetInfeasible(UFFProblem* prob);
 UFFLP_API UFFLP_ErrorType STDCALL UFFLP_ChangeBounds(UFFProblem* prob,
       char* vname, double lb, double ub);
 
+// Change the bounds of a variable given by its index. The problem can be
+// solved again after that. Do not call it inside a callback.
+// @param prob  pointer to the problem
+// @param vidx  index of the variable
+// @param lb new value of the variable's lower bound
+// @param ub new value of the variable's upper bound
+// @return an error code or UFFLP_Ok if successful
+UFFLP_API UFFLP_ErrorType STDCALL UFFLP_ChangeBoundsIdx(UFFProblem* prob,
+      int vidx, double lb, double ub);
+
+// Set an integer feasible solution to be used as the initial incumbent of the
+// next call to UFFLP_Solve. The values are given by variable index, and the
+// variables with index n or greater are considered as zeroes. The solution is
+// discarded by the solver if it is not feasible. Do not call it inside a
+// callback.
+// @param prob   pointer to the problem
+// @param n      number of values provided
+// @param values values of the variables 0, ..., n-1
+// @return an error code or UFFLP_Ok if successful
+UFFLP_API UFFLP_ErrorType STDCALL UFFLP_SetInitialSolution(UFFProblem* prob,
+      int n, double* values);
+
 };
 
 #endif
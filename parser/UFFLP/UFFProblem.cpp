@@ -15,6 +15,7 @@
 #include "/home/mateus/Cbc-2.4.0/include/coin/CbcFeasibilityBase.hpp"
 #include "/home/mateus/Cbc-2.4.0/include/coin/CbcCutGenerator.hpp"
 #include "/home/mateus/Cbc-2.4.0/include/coin/OsiAuxInfo.hpp"
+#include "/home/mateus/Cbc-2.4.0/include/coin/CoinTime.hpp"
 
 /*
 #include <OsiCbcSolverInterface.hpp>
@@ -23,19 +24,144 @@
 #include <CbcStrategy.hpp>
 #include <CbcFeasibilityBase.hpp>
 #include <CbcCutGenerator.hpp>
+#include <CoinTime.hpp>
 */
 
 #include "UFFProblem.h"
 
 #include <sstream>
+#include <string.h>
 
 #define UFFLP_VERSION   "2.0 over Coin-Cbc 2.4"
 
+//====================== NAME MAP ==========================
+
+UFFNameMap::UFFNameMap()
+{
+   slots.assign( 16, -1 );
+}
+
+unsigned int UFFNameMap::hash(const char* name)
+{
+   unsigned int h = 2166136261u;
+   for (; *name != '\0'; name++)
+   {
+      h ^= (unsigned char)*name;
+      h *= 16777619u;
+   }
+   return h;
+}
+
+int UFFNameMap::find(const char* name) const
+{
+   unsigned int mask = slots.size() - 1;
+   unsigned int h = hash( name );
+   for (unsigned int s = h & mask; slots[s] != -1; s = (s + 1) & mask)
+   {
+      int i = slots[s];
+      if ((hashes[i] == h) && (strcmp( &pool[offsets[i]], name ) == 0))
+         return values[i];
+   }
+   return -1;
+}
+
+void UFFNameMap::insert(const char* name, int value)
+{
+   // keep the load factor at most 1/2
+   if (2 * (values.size() + 1) > slots.size()) grow();
+
+   // store the name in the pool
+   int i = values.size();
+   offsets.push_back( pool.size() );
+   pool.insert( pool.end(), name, name + strlen( name ) + 1 );
+   hashes.push_back( hash( name ) );
+   values.push_back( value );
+
+   // find a free slot by linear probing
+   unsigned int mask = slots.size() - 1;
+   unsigned int s = hashes[i] & mask;
+   while (slots[s] != -1) s = (s + 1) & mask;
+   slots[s] = i;
+}
+
+void UFFNameMap::clear()
+{
+   slots.assign( 16, -1 );
+   pool.clear();
+   offsets.clear();
+   hashes.clear();
+   values.clear();
+}
+
+void UFFNameMap::grow()
+{
+   slots.assign( 2 * slots.size(), -1 );
+   unsigned int mask = slots.size() - 1;
+   for (int i = 0; i < (int)values.size(); i++)
+   {
+      unsigned int s = hashes[i] & mask;
+      while (slots[s] != -1) s = (s + 1) & mask;
+      slots[s] = i;
+   }
+}
+
+//====================== PAIR SET ==========================
+
+#define UFF_EMPTY_PAIR   (~0ULL)
+
+UFFPairSet::UFFPairSet()
+{
+   slots.assign( 16, UFF_EMPTY_PAIR );
+   count = 0;
+}
+
+bool UFFPairSet::insert(int a, int b)
+{
+   // keep the load factor at most 1/2
+   if (2 * (count + 1) > (int)slots.size()) grow();
+
+   // pack the pair and look for it by linear probing
+   unsigned long long key = ((unsigned long long)a << 32) | (unsigned int)b;
+   unsigned long long mask = slots.size() - 1;
+   unsigned long long s = (key * 0x9E3779B97F4A7C15ULL) >> 32;
+   for (s &= mask; slots[s] != UFF_EMPTY_PAIR; s = (s + 1) & mask)
+      if (slots[s] == key) return false;
+   slots[s] = key;
+   count++;
+   return true;
+}
+
+void UFFPairSet::clear()
+{
+   slots.assign( 16, UFF_EMPTY_PAIR );
+   count = 0;
+}
+
+void UFFPairSet::grow()
+{
+   std::vector<unsigned long long> old;
+   old.swap( slots );
+   slots.assign( 2 * old.size(), UFF_EMPTY_PAIR );
+   unsigned long long mask = slots.size() - 1;
+   for (int i = 0; i < (int)old.size(); i++)
+   {
+      if (old[i] == UFF_EMPTY_PAIR) continue;
+      unsigned long long s = ((old[i] * 0x9E3779B97F4A7C15ULL) >> 32) & mask;
+      while (slots[s] != UFF_EMPTY_PAIR) s = (s + 1) & mask;
+      slots[s] = old[i];
+   }
+}
+
 //====================== CUT GENERATION ==========================
 
 void UFFCutGenerator::generateCuts( const OsiSolverInterface & si,
       OsiCuts & cs, const CglTreeInfo info ) const
 {
+   // the generator added to the model is a copy, so the callback and the log
+   // file are taken from the problem's one, which is kept up to date
+   UFFLP_CallBackFunction userCutFunc = problem->userCutGen.userCutFunc;
+   FILE* logFile = problem->userCutGen.logFile;
+
    // check if a user callback is defined
    if (userCutFunc != NULL)
    {
@@ -47,7 +173,8 @@ void UFFCutGenerator::generateCuts( const OsiSolverInterface & si,
 
       // clear the cut coefficients
       problem->cutCoeffMap.clear();
-      problem->coeffCutMap.clear();
+      problem->cutCoeffs.clear();
+      problem->coeffCutSet.clear();
 
       // call the user's cut generation routine
       (*userCutFunc)( problem );
@@ -89,6 +216,11 @@ int UFFPrimalHeuristic::solution(double & solutionValue,
    bool hasBetterSol = false;
    int n = problem->solver->getNumCols();
 
+   // the heuristic added to the model is a copy, so the callback and the log
+   // file are taken from the problem's one, which is kept up to date
+   UFFLP_CallBackFunction userHeurFunc = problem->userHeur->userHeurFunc;
+   FILE* logFile = problem->userHeur->logFile;
+
    // if must check integer feasibility, disable all the other heuristics
    if (problem->feasibilityCheck)
    {
@@ -214,11 +346,18 @@ UFFProblem::UFFProblem()
    generatingCuts = false;
    userHeur = new UFFPrimalHeuristic( *model );
    inHeuristic = false;
+   callBackData = NULL;
 
    // initialize other stuff
    cutoffValue = solver->getInfinity();
    hasIntegerVar = false;
    hasBeenSolved = false;
+   solvedNumCols = 0;
+   syncSeconds = optimizeSeconds = 0.0;
+   solvedNodes = solvedIterations = 0;
+   solvedGap = 0.0;
+   userCutGenIdx = -1;
+   userHeurAdded = false;
    probCache.sync = false;
    feasibilityCheck = false;
 }
@@ -232,7 +371,7 @@ UFFProblem::~UFFProblem()
 //====================== API FUNCTIONS ==========================
 
 UFFLP_ErrorType UFFProblem::addVariable( char* name, double lb, double ub,
-      double obj, UFFLP_VarType type )
+      double obj, UFFLP_VarType type, int* idxOut )
 {
    // check the variable type
    if ( (type != UFFLP_Continuous) && (type != UFFLP_Integer)
@@ -257,17 +396,18 @@ UFFLP_ErrorType UFFProblem::addVariable( char* name, double lb, double ub,
       ub2 = -solver->getInfinity();
 
    // check if the variable name exists
-   std::map<std::string,int>::iterator it = varMap.find( name );
-   if (it != varMap.end()) return UFFLP_VarNameExists;
-
-   // check if at least one column coefficient is set
    Constraint* pcol = NULL;
-   std::map<std::string,Constraint>::iterator it2 =
-         varCoeffMap.find( name );
-   if (it2 != varCoeffMap.end())
+   if (name != NULL)
    {
-      // get the column coefficients
-      pcol = &varCoeffMap[name];
+      if (varMap.find( name ) != -1) return UFFLP_VarNameExists;
+
+      // check if at least one column coefficient is set
+      int colPos = varCoeffMap.find( name );
+      if (colPos != -1)
+      {
+         // get the column coefficients
+         pcol = &varCoeffs[colPos];
+      }
    }
 
    // if not using the problem cache
@@ -321,14 +461,20 @@ UFFLP_ErrorType UFFProblem::addVariable( char* name, double lb, double ub,
       }
    }
 
+   // keep the user's bounds and objective coefficient
+   userColLb.push_back( lb2 );
+   userColUb.push_back( ub2 );
+   userObj.push_back( obj );
+
    // save the variable index associated to its name
 #ifdef _DEBUG
    FILE* f = fopen( "debug.txt", "at" );
-   fprintf( f, "Adding variable %s with index %d\n", name, idx );
+   fprintf( f, "Adding variable %s with index %d\n",
+         (name != NULL)? name: "(unnamed)", idx );
    fclose( f );
 #endif
-   std::pair<const std::string,int> var(name, idx);
-   varMap.insert( var );
+   if (name != NULL) varMap.insert( name, idx );
+   if (idxOut != NULL) *idxOut = idx;
 
    return UFFLP_Ok;
 }
@@ -343,12 +489,10 @@ UFFLP_ErrorType UFFProblem::setCoefficient( char* cname, char* vname,
    varIdx = ctrIdx = -1;
 
    // check if the constraint is not already added
-   std::map<std::string,int>::iterator it = ctrMap.find( cname );
-   if (it != ctrMap.end()) ctrIdx = it->second;
+   ctrIdx = ctrMap.find( cname );
 
    // find the variable index
-   std::map<std::string,int>::iterator it2 = varMap.find( vname );
-   if (it2 != varMap.end()) varIdx = it2->second;
+   varIdx = varMap.find( vname );
 
    // if generating cuts...
    if (generatingCuts)
@@ -357,30 +501,22 @@ UFFLP_ErrorType UFFProblem::setCoefficient( char* cname, char* vname,
       if (varIdx == -1) return UFFLP_VarNameNotFound;
       if (ctrIdx >= 0) return UFFLP_ConsNameExists;
 
-      // check whether the coefficient exist
-      std::stringstream s;
-      std::string coefname;
-      s << vname << "@" << cname;
-      s >> coefname;
-      std::map<std::string,int>::iterator it4 = coeffCutMap.find( coefname );
-      if (it4 != coeffCutMap.end())
-         return UFFLP_CoeffExists;
-
       // add a new cut if it does not exist
-      std::map<std::string,Constraint>::iterator it3 =
-            cutCoeffMap.find( cname );
-      if (it3 == cutCoeffMap.end())
+      int cutPos = cutCoeffMap.find( cname );
+      if (cutPos == -1)
       {
          Constraint ctr;
          ctr.added = false;
-         std::pair<const std::string,Constraint> cutCoeff(cname, ctr);
-         cutCoeffMap.insert( cutCoeff );
+         cutPos = cutCoeffs.size();
+         cutCoeffs.push_back( ctr );
+         cutCoeffMap.insert( cname, cutPos );
       }
 
+      // check whether the coefficient exist
+      if (!coeffCutSet.insert( varIdx, cutPos )) return UFFLP_CoeffExists;
+
       // set the variable coefficient in the cut
-      Constraint* pctr = &cutCoeffMap[cname];
-      std::pair<const std::string,int> coeff(coefname, pctr->indices.size());
-      coeffCutMap.insert( coeff );
+      Constraint* pctr = &cutCoeffs[cutPos];
       pctr->indices.push_back( varIdx );
       pctr->coeffs.push_back( value );
    }
@@ -388,33 +524,24 @@ UFFLP_ErrorType UFFProblem::setCoefficient( char* cname, char* vname,
    // if not generating cuts...
    else
    {
-      std::map<std::string,Constraint>::iterator it3;
-
-      // check whether the coefficient exist
-      std::stringstream s;
-      std::string coefname;
-      s << vname << "@" << cname;
-      s >> coefname;
-      std::map<std::string,int>::iterator it4 = coeffCtrMap.find( coefname );
-      if (it4 != coeffCtrMap.end())
-         return UFFLP_CoeffExists;
-
       if ((varIdx >= 0) && (ctrIdx == -1))
       {
          // add a new constraint if it does not exist
-         it3 = ctrCoeffMap.find( cname );
-         if (it3 == ctrCoeffMap.end())
+         int ctrPos = ctrCoeffMap.find( cname );
+         if (ctrPos == -1)
          {
             Constraint ctr;
             ctr.added = false;
-            std::pair<const std::string,Constraint> ctrCoeff(cname, ctr);
-            ctrCoeffMap.insert( ctrCoeff );
+            ctrPos = ctrCoeffs.size();
+            ctrCoeffs.push_back( ctr );
+            ctrCoeffMap.insert( cname, ctrPos );
          }
 
+         // check whether the coefficient exist
+         if (!coeffCtrSet.insert( varIdx, ctrPos )) return UFFLP_CoeffExists;
+
          // set the variable coefficient in the constraint
-         Constraint* pctr = &ctrCoeffMap[cname];
-         std::pair<const std::string,int> coeff(coefname, pctr->indices.size());
-         coeffCtrMap.insert( coeff );
+         Constraint* pctr = &ctrCoeffs[ctrPos];
          pctr->indices.push_back( varIdx );
          pctr->coeffs.push_back( value );
       }
@@ -422,18 +549,20 @@ UFFLP_ErrorType UFFProblem::setCoefficient( char* cname, char* vname,
       else if ((varIdx == -1) && (ctrIdx >= 0))
       {
          // add a new variable if it does not exist
-         it3 = varCoeffMap.find( vname );
-         if (it3 == varCoeffMap.end())
+         int colPos = varCoeffMap.find( vname );
+         if (colPos == -1)
          {
             Constraint col;
-            std::pair<const std::string,Constraint> varCoeff(vname, col);
-            varCoeffMap.insert( varCoeff );
+            colPos = varCoeffs.size();
+            varCoeffs.push_back( col );
+            varCoeffMap.insert( vname, colPos );
          }
 
+         // check whether the coefficient exist
+         if (!coeffVarSet.insert( colPos, ctrIdx )) return UFFLP_CoeffExists;
+
          // set the constraint coefficient in the variable
-         Constraint* pcol = &varCoeffMap[vname];
-         std::pair<const std::string,int> coeff(coefname, ctrIdx);
-         coeffCtrMap.insert( coeff );
+         Constraint* pcol = &varCoeffs[colPos];
          pcol->indices.push_back( ctrIdx );
          pcol->coeffs.push_back( value );
       }
@@ -456,24 +585,22 @@ UFFLP_ErrorType UFFProblem::addConstraint( char* name, double rhs,
    if (generatingCuts)
    {
       // check if at least one cut coefficient is set
-      std::map<std::string,Constraint>::iterator it =
-            cutCoeffMap.find( name );
-      if (it == cutCoeffMap.end()) return UFFLP_ConsNameNotFound;
+      int cutPos = cutCoeffMap.find( name );
+      if (cutPos == -1) return UFFLP_ConsNameNotFound;
 
       // get the cut coefficients
-      pctr = &cutCoeffMap[name];
+      pctr = &cutCoeffs[cutPos];
    }
 
    // if not generating cuts...
    else
    {
       // check if at least one constraint coefficient is set
-      std::map<std::string,Constraint>::iterator it =
-            ctrCoeffMap.find( name );
-      if (it == ctrCoeffMap.end()) return UFFLP_ConsNameNotFound;
+      int ctrPos = ctrCoeffMap.find( name );
+      if (ctrPos == -1) return UFFLP_ConsNameNotFound;
 
       // get the constraint coefficients
-      pctr = &ctrCoeffMap[name];
+      pctr = &ctrCoeffs[ctrPos];
    }
 
    // check if the constraint has already been added
@@ -481,12 +608,8 @@ UFFLP_ErrorType UFFProblem::addConstraint( char* name, double rhs,
    pctr->added = true;
 
    // set the constraint's lower and upper bounds
-   double lb = -solver->getInfinity();
-   double ub = solver->getInfinity();
-   if ( (type == UFFLP_Equal) || (type == UFFLP_Greater) )
-      lb = rhs;
-   if ( (type == UFFLP_Equal) || (type == UFFLP_Less) )
-      ub = rhs;
+   double lb, ub;
+   rowBounds( rhs, type, &lb, &ub );
 
    // if generating cuts...
    if (generatingCuts)
@@ -514,45 +637,96 @@ UFFLP_ErrorType UFFProblem::addConstraint( char* name, double rhs,
       fclose( f );
 #endif
 
-      // if not using the problem cache
-      int idx = 0;
-      if (probCache.sync)
-      {
-         // add the constraint to the model
-         idx = solver->getNumRows();
-         solver->addRow( pctr->indices.size(), &pctr->indices[0], &pctr->coeffs[0],
-               lb, ub );
-      }
-      else
+      // insert the row in the solver or in the problem cache
+      int idx = insertRow( pctr->indices.size(), &pctr->indices[0],
+            &pctr->coeffs[0], lb, ub );
+
+      // save the constraint index associated to its name
+      ctrMap.insert( name, idx );
+   }
+
+   return UFFLP_Ok;
+}
+
+UFFLP_ErrorType UFFProblem::addRow(char* name, int nz, int* indices,
+      double* coeffs, double rhs, UFFLP_ConsType type, int* idx)
+{
+   // check whether inside a callback other than cut
+   if (inHeuristic) return UFFLP_InNonCutCallback;
+
+   // check the variable indices
+   int n = numCols();
+   for (int i = 0; i < nz; i++)
+      if ((indices[i] < 0) || (indices[i] >= n)) return UFFLP_InvalidIndex;
+
+   // check if the constraint name exists
+   if (name != NULL)
+   {
+      if (ctrMap.find( name ) != -1) return UFFLP_ConsNameExists;
+      if (generatingCuts)
       {
-         // insert the column in the problem cache
-         idx = probCache.rowlb.size();
-         for (int i = 0; i < (int)pctr->indices.size(); i++)
-         {
-            probCache.indexMatrix[pctr->indices[i]].push_back( idx );
-            probCache.valueMatrix[pctr->indices[i]].push_back(
-                     pctr->coeffs[i] );
-         }
-         probCache.rowlb.push_back( lb );
-         probCache.rowub.push_back( ub );
+         if (cutCoeffMap.find( name ) != -1)
+            return UFFLP_ConsNameExists;
       }
+      else if (ctrCoeffMap.find( name ) != -1)
+         return UFFLP_ConsNameExists;
+   }
 
-      // save the constraint index associated to its name
-      std::pair<const std::string,int> ctr(name, idx);
-      ctrMap.insert( ctr );
+   // set the constraint's lower and upper bounds
+   double lb, ub;
+   rowBounds( rhs, type, &lb, &ub );
+
+   // if generating cuts...
+   if (generatingCuts)
+   {
+      OsiRowCut cut;
+      cut.setRow( nz, indices, coeffs );
+      cut.setLb(lb);
+      cut.setUb(ub);
+      cutCollection->insert(cut);
+      if (idx != NULL) *idx = -1;
+      return UFFLP_Ok;
    }
 
+   // insert the row in the solver or in the problem cache
+   int ctrIdx = insertRow( nz, indices, coeffs, lb, ub );
+
+   // save the constraint index associated to its name
+   if (name != NULL) ctrMap.insert( name, ctrIdx );
+   if (idx != NULL) *idx = ctrIdx;
+
    return UFFLP_Ok;
 }
 
 UFFLP_StatusType UFFProblem::solve(UFFLP_ObjSense sense)
 {
    // Synchronize the cache of variables and constraints with the COIN-OR
+   double startTime = CoinGetTimeOfDay();
    synchronizeProblem();
+   syncSeconds = CoinGetTimeOfDay() - startTime;
+   startTime = CoinGetTimeOfDay();
 
    // Set the objective function sense
-   if (sense == UFFLP_Maximize)
-      solver->setObjSense( -1 );
+   solver->setObjSense( (sense == UFFLP_Maximize)? -1: 1 );
+
+   // Clear the search state left by a previous solve, so that the changes
+   // made since then are taken into account, but keep its incumbent as the
+   // initial one unless the user has provided another
+   if (hasBeenSolved && hasIntegerVar)
+   {
+      if (initialSolution.empty() && (model->bestSolution() != NULL))
+      {
+         initialSolution.assign( model->bestSolution(),
+               model->bestSolution() + solvedNumCols );
+         initialSolution.resize( model->getNumCols(), 0.0 );
+      }
+      model->resetModel();
+   }
+
+   // Undo the bound fixings left in the solver by a previous search, which
+   // are only valid for its objective and cutoff
+   if (hasBeenSolved)
+      restoreUserColumns();
 
    // Check if a log file name has been set
    FILE* f = NULL;
@@ -573,9 +747,11 @@ UFFLP_StatusType UFFProblem::solve(UFFLP_ObjSense sense)
       model->passInMessageHandler( &newModelLog );
    }
 
-   // Set the cutoff value
+   // Set the cutoff value (or reset the one left by a previous solve)
    if (cutoffValue != solver->getInfinity())
       model->setCutoff( cutoffValue * solver->getObjSense() );
+   else if (hasBeenSolved)
+      model->setCutoff( COIN_DBL_MAX );
 
    // Set log level for (0 - B&B, 1 - solver, 3 - cut gen)
    model->messageHandler()->setLogLevel( 0, logLevel );
@@ -624,21 +800,29 @@ UFFLP_StatusType UFFProblem::solve(UFFLP_ObjSense sense)
          // Set the cut generator (set the "normal" flag true, both the "atSolution"
          // and the "infeasible" flags false, the "howOftenInSub" parameter -100,
          // the "whatDepth" parameter 1, and the "whatDepthInSub" parameters -1
+         // (only once, since the model keeps them between solves)
          userCutGen.problem = this;
          userCutGen.logFile = f;
-         model->addCutGenerator( &userCutGen, 1, "UFFLP_User", true, false, false,
-               -100, 1, -1 );
+         if (userCutGenIdx == -1)
+         {
+            userCutGenIdx = model->numberCutGenerators();
+            model->addCutGenerator( &userCutGen, 1, "UFFLP_User", true, false,
+                  false, -100, 1, -1 );
+         }
 
-         // Set the primal heuristic
+         // Set the primal heuristic (only once as well)
          userHeur->problem = this;
          userHeur->logFile = f;
-         model->addHeuristic( userHeur, "UFFLP_User", 0 );
+         if (!userHeurAdded)
+         {
+            model->addHeuristic( userHeur, "UFFLP_User", 0 );
+            userHeurAdded = true;
+         }
 
          if (feasibilityCheck)
          {
             // Make sure cut generator called correctly (a)
-            int iGenerator = model->numberCutGenerators() - 1;
-            model->cutGenerator(iGenerator)->setMustCallAgain(true);
+            model->cutGenerator(userCutGenIdx)->setMustCallAgain(true);
             // Say cuts needed at continuous (b)
             OsiBabSolver oddCuts;
             oddCuts.setSolverType(4);
@@ -663,6 +847,18 @@ UFFLP_StatusType UFFProblem::solve(UFFLP_ObjSense sense)
          model->setMaximumCutPasses(2);
          model->setAllowablePercentageGap(0.01); // the same as the CPLEX default
 
+         // Set the user's initial incumbent, which is checked by the CBC and
+         // also works as a cutoff for the search
+         if ((int)initialSolution.size() == model->getNumCols())
+         {
+            const double* coeffs = solver->getObjCoefficients();
+            double objVal = 0.0;
+            for (int i = 0; i < model->getNumCols(); i++)
+               objVal += coeffs[i] * initialSolution[i];
+            model->setBestSolution( &initialSolution[0],
+                  model->getNumCols(), objVal * solver->getObjSense(), true );
+         }
+
          // Solve the MIP
          int ns = 5;
          if (model->getNumCols()<5000) ns = 20;
@@ -678,11 +874,42 @@ UFFLP_StatusType UFFProblem::solve(UFFLP_ObjSense sense)
             model->setPrintFrequency(100);
          model->branchAndBound();
       }
-      hasBeenSolved = true;
    }
    else
-      // Solve the relaxation
-      solver->initialSolve();
+   {
+      // Solve the relaxation (from the previous basis if any)
+      if (hasBeenSolved)
+         solver->resolve();
+      else
+         solver->initialSolve();
+   }
+   hasBeenSolved = true;
+   solvedNumCols = solver->getNumCols();
+
+   // Keep the statistics of this solve
+   optimizeSeconds = CoinGetTimeOfDay() - startTime;
+   solvedNodes = 0;
+   solvedGap = 0.0;
+   if (hasIntegerVar && !solvedByInitial)
+   {
+      solvedNodes = model->getNodeCount();
+      solvedIterations = model->getIterationCount();
+      if (model->bestSolution() != NULL)
+      {
+         double best = model->getObjValue();
+         double bound = model->getBestPossibleObjValue();
+         solvedGap = fabs(best - bound) / CoinMax(fabs(best), 1e-10);
+      }
+      else
+         solvedGap = UFFLP_Infinity;
+   }
+   else if (hasIntegerVar)
+      solvedIterations = model->solver()->getIterationCount();
+   else
+      solvedIterations = solver->getIterationCount();
+
+   // The user's initial incumbent is only used once
+   initialSolution.clear();
 
    if (f != NULL)
    {
@@ -692,6 +919,8 @@ UFFLP_StatusType UFFProblem::solve(UFFLP_ObjSense sense)
 
       // Close the log file
       fclose( f );
+      userCutGen.logFile = NULL;
+      userHeur->logFile = NULL;
    }
 
    // Set log level zero (no log message) out of "UFFLP_Solve"
@@ -752,9 +981,8 @@ UFFLP_ErrorType UFFProblem::getObjValue(double* value)
 UFFLP_ErrorType UFFProblem::getSolution(char* vname, double* value)
 {
    // find the variable index
-   std::map<std::string,int>::iterator it2 = varMap.find( vname );
-   if (it2 == varMap.end()) return UFFLP_VarNameNotFound;
-   int varIdx = it2->second;
+   int varIdx = varMap.find( vname );
+   if (varIdx == -1) return UFFLP_VarNameNotFound;
 
    // get the variable value and store it at the user's area
    const double *solution;
@@ -765,12 +993,66 @@ UFFLP_ErrorType UFFProblem::getSolution(char* vname, double* value)
    return UFFLP_Ok;
 }
 
+UFFLP_ErrorType UFFProblem::getSolution(int vidx, double* value)
+{
+   // check the variable index
+   if ((vidx < 0) || (vidx >= solver->getNumCols())) return UFFLP_InvalidIndex;
+
+   // get the variable value and store it at the user's area
+   const double *solution;
+   solution = solver->getColSolution();
+   if (solution == NULL) return UFFLP_NoSolExists;
+   *value = solution[vidx];
+
+   return UFFLP_Ok;
+}
+
+UFFLP_ErrorType UFFProblem::getSolutionVector(double* values, int n)
+{
+   // check the number of variables
+   if ((n < 0) || (n > solver->getNumCols())) return UFFLP_InvalidIndex;
+
+   // copy the variable values to the user's area
+   const double *solution;
+   solution = solver->getColSolution();
+   if (solution == NULL) return UFFLP_NoSolExists;
+   memcpy( values, solution, n*sizeof(double) );
+
+   return UFFLP_Ok;
+}
+
+UFFLP_ErrorType UFFProblem::getSolutionNonzeros(double toler, int* indices,
+      double* values, int n, int* nz)
+{
+   // get the current solution
+   const double *solution;
+   solution = solver->getColSolution();
+   if (solution == NULL) return UFFLP_NoSolExists;
+
+   // copy the values greater than the tolerance to the user's area
+   int count = 0;
+   for (int i = 0; i < solver->getNumCols(); i++)
+   {
+      if (fabs(solution[i]) > toler)
+      {
+         if (count < n)
+         {
+            indices[count] = i;
+            values[count] = solution[i];
+         }
+         count++;
+      }
+   }
+   *nz = count;
+
+   return UFFLP_Ok;
+}
+
 UFFLP_ErrorType UFFProblem::getDualSolution(char* cname, double* value)
 {
    // find the constraint index
-   std::map<std::string,int>::iterator it = ctrMap.find( cname );
-   if (it == ctrMap.end()) return UFFLP_ConsNameNotFound;
-   int ctrIdx = it->second;
+   int ctrIdx = ctrMap.find( cname );
+   if (ctrIdx == -1) return UFFLP_ConsNameNotFound;
 
    // if inside a callback...
    if (generatingCuts || inHeuristic)
@@ -795,28 +1077,47 @@ UFFLP_ErrorType UFFProblem::getDualSolution(char* cname, double* value)
 
 UFFLP_ErrorType UFFProblem::writeLP(char* fname)
 {
-   std::map<std::string,int>::iterator it;
-   static char objName[] = "obj";
-
    // Synchronize the cache of variables and constraints with the COIN-OR
    synchronizeProblem();
 
    // build a vector of variable names
    std::vector<const char*> varNames;
-   varNames.resize( varMap.size(), NULL );
-   for (it = varMap.begin(); it != varMap.end(); it++)
+   varNames.resize( solver->getNumCols(), NULL );
+   for (int i = 0; i < varMap.size(); i++)
    {
-      varNames[it->second] = (it->first).c_str();
+      varNames[varMap.value( i )] = varMap.name( i );
    }
 
    // build a vector of constraint names
    std::vector<const char*> ctrNames;
-   ctrNames.resize( ctrMap.size()+1, NULL );
-   for (it = ctrMap.begin(); it != ctrMap.end(); it++)
+   ctrNames.resize( solver->getNumRows()+1, NULL );
+   for (int i = 0; i < ctrMap.size(); i++)
    {
-      ctrNames[it->second] = (it->first).c_str();
+      ctrNames[ctrMap.value( i )] = ctrMap.name( i );
+   }
+   // (the objective row name is a literal, so that no state is shared between
+   // problems written at the same time by different threads)
+   ctrNames[solver->getNumRows()] = "obj";
+
+   // generate names for the variables and constraints inserted without one
+   std::vector<std::string> genNames;
+   genNames.reserve( varNames.size() + ctrNames.size() );
+   for (int c = 0; c < (int)varNames.size(); c++)
+   {
+      if (varNames[c] != NULL) continue;
+      std::stringstream s;
+      s << "C" << c;
+      genNames.push_back( s.str() );
+      varNames[c] = genNames.back().c_str();
+   }
+   for (int r = 0; r < (int)ctrNames.size(); r++)
+   {
+      if (ctrNames[r] != NULL) continue;
+      std::stringstream s;
+      s << "R" << r;
+      genNames.push_back( s.str() );
+      ctrNames[r] = genNames.back().c_str();
    }
-   ctrNames[ctrMap.size()] = objName;
 
    // Check if the LP file can be open for writing
    FILE* f = fopen( fname, "wt" );
@@ -895,9 +1196,8 @@ UFFLP_ErrorType UFFProblem::setSolution(char* vname, double value)
    if ( !inHeuristic ) return UFFLP_NotInHeuristic;
 
    // find the variable index
-   std::map<std::string,int>::iterator it = varMap.find( vname );
-   if (it == varMap.end()) return UFFLP_VarNameNotFound;
-   int varIdx = it->second;
+   int varIdx = varMap.find( vname );
+   if (varIdx == -1) return UFFLP_VarNameNotFound;
 
    // set the variable value
    primalSolution[varIdx] = value;
@@ -908,6 +1208,23 @@ UFFLP_ErrorType UFFProblem::setSolution(char* vname, double value)
    return UFFLP_Ok;
 }
 
+UFFLP_ErrorType UFFProblem::setSolution(int vidx, double value)
+{
+   // check if we are in the heuristic context
+   if ( !inHeuristic ) return UFFLP_NotInHeuristic;
+
+   // check the variable index
+   if ((vidx < 0) || (vidx >= solver->getNumCols())) return UFFLP_InvalidIndex;
+
+   // set the variable value
+   primalSolution[vidx] = value;
+
+   // set the solution flag
+   newSolutionSet = true;
+
+   return UFFLP_Ok;
+}
+
 UFFLP_ErrorType UFFProblem::setParameter(UFFLP_ParameterType param,
       double value)
 {
@@ -933,18 +1250,94 @@ UFFLP_ErrorType UFFProblem::setParameter(UFFLP_ParameterType param,
    return UFFLP_Ok;
 }
 
+UFFLP_ErrorType UFFProblem::getSolveInfo(UFFLP_InfoType info, double* value)
+{
+   // check if we are in a callback context
+   if ( inHeuristic || generatingCuts ) return UFFLP_InCallback;
+
+   // the model size comes from the solver once synchronized
+   switch (info)
+   {
+   case UFFLP_NumRows:
+      *value = probCache.sync? solver->getNumRows(): probCache.rowlb.size();
+      return UFFLP_Ok;
+
+   case UFFLP_NumCols:
+      *value = numCols();
+      return UFFLP_Ok;
+
+   case UFFLP_NumNonzeros:
+      if (probCache.sync)
+         *value = solver->getNumElements();
+      else
+      {
+         *value = 0;
+         for (int c = 0; c < (int)probCache.indexMatrix.size(); c++)
+            *value += probCache.indexMatrix[c].size();
+      }
+      return UFFLP_Ok;
+
+   default:
+      break;
+   }
+
+   // the other statistics refer to the last solve
+   if (!hasBeenSolved) return UFFLP_NoSolExists;
+   switch (info)
+   {
+   case UFFLP_NodeCount:
+      *value = solvedNodes;
+      break;
+
+   case UFFLP_IterationCount:
+      *value = solvedIterations;
+      break;
+
+   case UFFLP_RelativeGap:
+      *value = solvedGap;
+      break;
+
+   case UFFLP_SyncTime:
+      *value = syncSeconds;
+      break;
+
+   case UFFLP_OptimizeTime:
+      *value = optimizeSeconds;
+      break;
+
+   default:
+      return UFFLP_InvalidParameter;
+   }
+
+   return UFFLP_Ok;
+}
+
 UFFLP_ErrorType UFFProblem::changeObjCoeff(char* vname, double value)
 {
    // check if we are in a callback context
    if ( inHeuristic || generatingCuts ) return UFFLP_InCallback;
 
    // find the variable index
-   std::map<std::string,int>::iterator it = varMap.find( vname );
-   if (it == varMap.end()) return UFFLP_VarNameNotFound;
-   int varIdx = it->second;
+   int varIdx = varMap.find( vname );
+   if (varIdx == -1) return UFFLP_VarNameNotFound;
 
-   // set the coefficient in the objective function
-   solver->setObjCoeff( varIdx, value );
+   return changeObjCoeff( varIdx, value );
+}
+
+UFFLP_ErrorType UFFProblem::changeObjCoeff(int vidx, double value)
+{
+   // check if we are in a callback context
+   if ( inHeuristic || generatingCuts ) return UFFLP_InCallback;
+
+   // check the variable index
+   if ((vidx < 0) || (vidx >= numCols())) return UFFLP_InvalidIndex;
+
+   // set the coefficient in the solver or in the problem cache
+   userObj[vidx] = value;
+   if (probCache.sync)
+      solver->setObjCoeff( vidx, value );
+   else
+      probCache.obj[vidx] = value;
 
    return UFFLP_Ok;
 }
@@ -960,12 +1353,12 @@ UFFLP_ErrorType UFFProblem::checkSolution(double toler)
    if ( !inHeuristic ) return UFFLP_NotInHeuristic;
 
    // check all constraints
-   std::map<std::string,Constraint>::iterator it;
-   for (it = ctrCoeffMap.begin(); it != ctrCoeffMap.end(); it++)
+   for (int c = 0; c < ctrCoeffMap.size(); c++)
    {
       // calculate the left-hand side for the current constraint
       double lhs = 0.0;
-      Constraint* pctr = &(it->second);
+      const char* cname = ctrCoeffMap.name( c );
+      Constraint* pctr = &ctrCoeffs[ctrCoeffMap.value( c )];
       if (!pctr->added) continue;   // skip the constraints not added
       for (int i = 0; i < (int)pctr->indices.size(); i++)
          lhs += pctr->coeffs[i] * primalSolution[pctr->indices[i]];
@@ -973,7 +1366,7 @@ UFFLP_ErrorType UFFProblem::checkSolution(double toler)
       // get the constraint right-hand side and the sense
       double rhs;
       char sense;
-      int ctrIdx = ctrMap[it->first];
+      int ctrIdx = ctrMap.find( cname );
       rhs = solver->getRightHandSide()[ctrIdx];
       sense = solver->getRowSense()[ctrIdx];
 
@@ -984,7 +1377,7 @@ UFFLP_ErrorType UFFProblem::checkSolution(double toler)
          if (lhs > rhs + toler)
          {
             std::stringstream s;
-            s << "Heuristic solution violates constraint " << it->first
+            s << "Heuristic solution violates constraint " << cname
                   << " with " << lhs << " greater than " << rhs;
             printToLog((char*)s.str().c_str());
             return UFFLP_InfeasibleSol;
@@ -994,7 +1387,7 @@ UFFLP_ErrorType UFFProblem::checkSolution(double toler)
          if (fabs(lhs - rhs) > toler)
          {
             std::stringstream s;
-            s << "Heuristic solution violates constraint " << it->first
+            s << "Heuristic solution violates constraint " << cname
                   << " with " << lhs << " not equal to " << rhs;
             printToLog((char*)s.str().c_str());
             return UFFLP_InfeasibleSol;
@@ -1004,7 +1397,7 @@ UFFLP_ErrorType UFFProblem::checkSolution(double toler)
          if (lhs < rhs - toler)
          {
             std::stringstream s;
-            s << "Heuristic solution violates constraint " << it->first
+            s << "Heuristic solution violates constraint " << cname
                   << " with " << lhs << " less than " << rhs;
             printToLog((char*)s.str().c_str());
             return UFFLP_InfeasibleSol;
@@ -1016,48 +1409,68 @@ UFFLP_ErrorType UFFProblem::checkSolution(double toler)
    return UFFLP_Ok;
 }
 
-void UFFProblem::synchronizeProblem()
+void UFFProblem::rowBounds(double rhs, UFFLP_ConsType type, double* lb,
+      double* ub)
 {
-   if (!probCache.sync)
-   {
-      double objVal = 0.0;
-      double *solution = NULL;
+   *lb = -solver->getInfinity();
+   *ub = solver->getInfinity();
+   if ( (type == UFFLP_Equal) || (type == UFFLP_Greater) )
+      *lb = rhs;
+   if ( (type == UFFLP_Equal) || (type == UFFLP_Less) )
+      *ub = rhs;
+}
 
-      // rebuild the solver if the problem has already been solved before
-      if (hasBeenSolved)
+int UFFProblem::insertRow(int nz, const int* indices, const double* coeffs,
+      double lb, double ub)
+{
+   // if not using the problem cache
+   int idx = 0;
+   if (probCache.sync)
+   {
+      // add the constraint to the model
+      idx = solver->getNumRows();
+      solver->addRow( nz, indices, coeffs, lb, ub );
+   }
+   else
+   {
+      // insert the row in the problem cache
+      idx = probCache.rowlb.size();
+      for (int i = 0; i < nz; i++)
       {
-         // save the best feasible solution if any
-         if (solver->getColSolution() != NULL)
-         {
-            solution = new double[solver->getNumCols()];
-            memcpy( solution, solver->getColSolution(),
-                  solver->getNumCols()*sizeof(double) );
-            objVal = solver->getObjValue();
-         }
-
-         // destroy the solver
-         delete solver;
-
-         // recreate the solver interface
-         OsiCbcSolverInterface* cbcSolver = new OsiCbcSolverInterface;
-         solver = cbcSolver;
-
-         // Get the branch-and-cut model
-         model = cbcSolver->getModelPtr();
+         probCache.indexMatrix[indices[i]].push_back( idx );
+         probCache.valueMatrix[indices[i]].push_back( coeffs[i] );
+      }
+      probCache.rowlb.push_back( lb );
+      probCache.rowub.push_back( ub );
+   }
+   return idx;
+}
 
-         // Set default log message handlers
-         model->solver()->passInMessageHandler( &solverLog );
-         model->passInMessageHandler( &modelLog );
+int UFFProblem::numCols()
+{
+   return probCache.sync? solver->getNumCols(): (int)probCache.collb.size();
+}
 
-         // Set log level zero (no log message) by default
-         // for (0 - B&B, 1 - solver, 3 - cut gen)
-         model->messageHandler()->setLogLevel( 0, 0 );
-         model->messageHandler()->setLogLevel( 1, 0 );
-         model->messageHandler()->setLogLevel( 3, 0 );
-      }
+void UFFProblem::restoreUserColumns()
+{
+   OsiSolverInterface* si = model->solver();
+   int n = si->getNumCols();
+   for (int c = 0; c < n; c++)
+   {
+      si->setColBounds( c, userColLb[c], userColUb[c] );
+      si->setObjCoeff( c, userObj[c] );
+   }
+}
 
+void UFFProblem::synchronizeProblem()
+{
+   if (!probCache.sync)
+   {
       // convert the problem matrix to the COIN-OR format
       int idx = 0;
+      probCache.start.clear();
+      probCache.index.clear();
+      probCache.value.clear();
       probCache.start.push_back( idx );
       for (int c = 0; c < (int)probCache.indexMatrix.size(); c++)
       {
@@ -1110,16 +1523,10 @@ void UFFProblem::synchronizeProblem()
             solver->setContinuous( c );
       }
 
-      // set the solution from the previous problem
-      if (solution != NULL)
-      {
-         model->saveBestSolution(solution, objVal);
-         delete [] solution;
-      }
-
-      // clear the cache
+      // clear the cache, since from now on the changes are applied directly
+      // to the solver
+      probCache = ProblemCache();
       probCache.sync = true;
-      hasBeenSolved = false;
    }
 }
 
@@ -1129,14 +1536,52 @@ UFFLP_ErrorType UFFProblem::changeBounds(char* vname, double lb, double ub)
    if ( inHeuristic || generatingCuts ) return UFFLP_InCallback;
 
    // find the variable index
-   std::map<std::string,int>::iterator it = varMap.find( vname );
-   if (it == varMap.end()) return UFFLP_VarNameNotFound;
-   int varIdx = it->second;
+   int varIdx = varMap.find( vname );
+   if (varIdx == -1) return UFFLP_VarNameNotFound;
 
-   // set the bounds
-   probCache.collb[varIdx] = lb;
-   probCache.colub[varIdx] = ub;
-   probCache.sync = false;
+   return changeBounds( varIdx, lb, ub );
+}
+
+UFFLP_ErrorType UFFProblem::setInitialSolution(int n, double* values)
+{
+   // check if we are in a callback context
+   if ( inHeuristic || generatingCuts ) return UFFLP_InCallback;
+
+   // check the number of values
+   if ((n < 0) || (n > numCols())) return UFFLP_InvalidIndex;
+
+   // store the solution until the next call to "solve"
+   initialSolution.assign( numCols(), 0.0 );
+   for (int i = 0; i < n; i++)
+      initialSolution[i] = values[i];
+
+   return UFFLP_Ok;
+}
+
+UFFLP_ErrorType UFFProblem::changeBounds(int vidx, double lb, double ub)
+{
+   // check if we are in a callback context
+   if ( inHeuristic || generatingCuts ) return UFFLP_InCallback;
+
+   // check the variable index
+   if ((vidx < 0) || (vidx >= numCols())) return UFFLP_InvalidIndex;
+
+   // convert the infinity values
+   if (lb == UFFLP_Infinity) lb = solver->getInfinity();
+   if (lb == -UFFLP_Infinity) lb = -solver->getInfinity();
+   if (ub == UFFLP_Infinity) ub = solver->getInfinity();
+   if (ub == -UFFLP_Infinity) ub = -solver->getInfinity();
+
+   // set the bounds in the solver or in the problem cache
+   userColLb[vidx] = lb;
+   userColUb[vidx] = ub;
+   if (probCache.sync)
+      solver->setColBounds( vidx, lb, ub );
+   else
+   {
+      probCache.collb[vidx] = lb;
+      probCache.colub[vidx] = ub;
+   }
 
    return UFFLP_Ok;
 }
@@ -12,7 +12,6 @@
 #define __UFF_PROBLEM_H__
 
 #include <string>
-#include <map>
 #include <vector>
 #include <stdio.h>
 
@@ -31,6 +30,71 @@ class OsiSolverInterface;
 class CbcModel;
 class UFFProblem;
 
+// Open-addressing hash table mapping names to integers. The names are
+// interned in a single character pool, so an insertion does not allocate a
+// node nor a string.
+class UFFNameMap
+{
+public:
+   UFFNameMap();
+
+   // Get the value associated to a name, or -1 if the name is not found.
+   int find(const char* name) const;
+
+   // Insert a name that is not in the map yet.
+   void insert(const char* name, int value);
+
+   // Remove all the names.
+   void clear();
+
+   // Get the number of names and the name and value of the i-th inserted
+   // one. The name pointer is only valid until the next insertion.
+   inline int size() const { return (int)values.size(); };
+   inline const char* name(int i) const { return &pool[offsets[i]]; };
+   inline int value(int i) const { return values[i]; };
+
+private:
+   // hash function for the names (FNV-1a)
+   static unsigned int hash(const char* name);
+
+   // double the number of slots and reinsert all the names
+   void grow();
+
+   // slots of the table with the index of an inserted name or -1 if empty
+   std::vector<int> slots;
+
+   // characters of the inserted names, each one followed by a '\0'
+   std::vector<char> pool;
+
+   // position in the pool, hash and value of each inserted name
+   std::vector<int> offsets;
+   std::vector<unsigned int> hashes;
+   std::vector<int> values;
+};
+
+// Open-addressing hash set of pairs of non-negative integers.
+class UFFPairSet
+{
+public:
+   UFFPairSet();
+
+   // Insert the pair (a, b). Return false if it was already in the set.
+   bool insert(int a, int b);
+
+   // Remove all the pairs.
+   void clear();
+
+private:
+   // double the number of slots and reinsert all the pairs
+   void grow();
+
+   // slots of the table with the packed pairs (or EMPTY)
+   std::vector<unsigned long long> slots;
+
+   // number of pairs in the set
+   int count;
+};
+
 struct Constraint
 {
    std::vector<int> indices;     // constraint indices
@@ -91,6 +155,11 @@ private:
    FILE* logFile;
 };
 
+// All the UFFLP state of a problem, including the solver objects and the
+// callback context, lives in its instance. Whether independent problems may
+// be solved at the same time by different threads also depends on the global
+// state of the COIN-OR libraries, which has not been verified (see the note
+// in UFFLP.h).
 class UFFProblem
 {
    // stores variables, coefficients and constraints
@@ -126,9 +195,10 @@ public:
    UFFProblem();
    ~UFFProblem();
 
-   // Insert a new variable into the problem
+   // Insert a new variable into the problem. The name may be NULL, and the
+   // index of the new variable is stored in idx if not NULL.
    UFFLP_ErrorType addVariable( char* name, double lb, double ub, double obj,
-      UFFLP_VarType type );
+      UFFLP_VarType type, int* idx = NULL );
 
    // Set a coefficient of a constraint before inserting it in the problem's
    // model.
@@ -140,6 +210,12 @@ public:
    // callback, then the constraint is inserted as a cut.
    UFFLP_ErrorType addConstraint(char* name, double rhs, UFFLP_ConsType type);
 
+   // Insert a constraint given all its coefficients by variable index. The
+   // name may be NULL, and the index of the new constraint is stored in idx if
+   // not NULL. Inside a cut callback, the constraint is inserted as a cut.
+   UFFLP_ErrorType addRow(char* name, int nz, int* indices, double* coeffs,
+         double rhs, UFFLP_ConsType type, int* idx);
+
    // Solve the problem. Return the solution status.
    UFFLP_StatusType solve(UFFLP_ObjSense sense);
 
@@ -151,6 +227,17 @@ public:
    // the values for the current LP relaxation are returned.
    UFFLP_ErrorType getSolution(char* vname, double* value);
 
+   // Get the value of a variable, given by its index, in the current solution.
+   UFFLP_ErrorType getSolution(int vidx, double* value);
+
+   // Copy the values of the first n variables in the current solution.
+   UFFLP_ErrorType getSolutionVector(double* values, int n);
+
+   // Copy the variables whose absolute values exceed toler (at most n of
+   // them) and store their total number in nz.
+   UFFLP_ErrorType getSolutionNonzeros(double toler, int* indices,
+         double* values, int n, int* nz);
+
    // Get the value of a dual variable in the current solution. Cannot be
    // called inside a callback.
    UFFLP_ErrorType getDualSolution(char* cname, double* value);
@@ -182,15 +269,26 @@ public:
    // as zeroes.
    UFFLP_ErrorType setSolution(char* vname, double value);
 
+   // Set the value of a variable, given by its index, in the integer solution
+   // provided by the user (only allowed in a heuristic callback).
+   UFFLP_ErrorType setSolution(int vidx, double value);
+
    // Set the value for a solver parameter. Both integer and floating point
    // parameters are set through this function. For integer parameters, the
    // value is truncated.
    UFFLP_ErrorType setParameter(UFFLP_ParameterType param, double value);
 
+   // Get a statistic of the model or of the last call to solve. The times are
+   // wall-clock seconds. Do not call it inside a callback.
+   UFFLP_ErrorType getSolveInfo(UFFLP_InfoType info, double* value);
+
    // Change the coefficient of a variable in the objective function. The
    // problem can be solved again after that. Do not call it inside a callback.
    UFFLP_ErrorType changeObjCoeff(char* vname, double value);
 
+   // Change the objective coefficient of a variable given by its index.
+   UFFLP_ErrorType changeObjCoeff(int vidx, double value);
+
    // Set the branching priority of a variable (CPLEX only, ignored by COIN-OR).
    // Variables with higher priorities are preferred. By default, variables receive
    // priority zero.
@@ -206,21 +304,57 @@ public:
    // Do not call it inside a callback.
    UFFLP_ErrorType changeBounds(char* vname, double lb, double ub);
 
+   // Change the bounds of a variable given by its index.
+   UFFLP_ErrorType changeBounds(int vidx, double lb, double ub);
+
+   // Set an integer solution, given by variable index, to be used as the
+   // initial incumbent of the next call to solve. Variables with index n or
+   // greater are considered as zeroes. Do not call it inside a callback.
+   UFFLP_ErrorType setInitialSolution(int n, double* values);
+
    // Indicate that the integer feasible solution may be infeasible for the
    // complete problem
    inline void setFeasibilityCheck(bool value)
    { feasibilityCheck = value; };
 
+   // Set and get the pointer to the user's data passed to the callbacks
+   inline void setCallBackData(void* data)
+   { callBackData = data; };
+   inline void* getCallBackData() const
+   { return callBackData; };
+
 private:
 
-   // set the problem data from the cache to the CBC
+   // load the problem data from the cache to the CBC (only before the first
+   // solve, since later changes are applied directly to the solver)
    void synchronizeProblem();
 
-   // map of variable-constraint coefficients to indices in the ctrCoeff map
-   std::map<std::string, int> coeffCtrMap;
+   // get the lower and upper bounds of a row from its right-hand side and type
+   void rowBounds(double rhs, UFFLP_ConsType type, double* lb, double* ub);
+
+   // insert a row either in the solver or in the problem cache and return its
+   // index
+   int insertRow(int nz, const int* indices, const double* coeffs, double lb,
+         double ub);
+
+   // get the current number of columns (in the solver or in the cache)
+   int numCols();
+
+   // apply the user's column bounds and objective coefficients again to the
+   // solver used by the branch-and-cut model
+   void restoreUserColumns();
 
-   // map of variable-constraint coefficients to indices in the cutCoeff map
-   std::map<std::string, int> coeffCutMap;
+   // set of (variable index, position in ctrCoeffs) pairs of the coefficients
+   // already set for constraints not yet added
+   UFFPairSet coeffCtrSet;
+
+   // set of (position in varCoeffs, constraint index) pairs of the coefficients
+   // already set for variables not yet added
+   UFFPairSet coeffVarSet;
+
+   // set of (variable index, position in cutCoeffs) pairs of the coefficients
+   // already set for the current cuts
+   UFFPairSet coeffCutSet;
 
    // Pointer to the solver interface
    OsiSolverInterface* solver;
@@ -241,27 +375,32 @@ private:
    int logLevel;
 
    // Map of variable names to variable indices in the solver
-   std::map<std::string,int> varMap;
+   UFFNameMap varMap;
 
    // Map of constraint names to constraint indices in the solver
-   std::map<std::string,int> ctrMap;
+   UFFNameMap ctrMap;
 
-   // Map of constraint names to constraint coefficients
-   std::map<std::string,Constraint> ctrCoeffMap;
+   // Map of constraint names to constraint coefficients (in ctrCoeffs)
+   UFFNameMap ctrCoeffMap;
+   std::vector<Constraint> ctrCoeffs;
 
-   // Map of cut names to cut coefficients
-   std::map<std::string,Constraint> cutCoeffMap;
+   // Map of cut names to cut coefficients (in cutCoeffs)
+   UFFNameMap cutCoeffMap;
+   std::vector<Constraint> cutCoeffs;
 
-   // Map of variable (column) names to column coefficients
-   std::map<std::string,Constraint> varCoeffMap;
+   // Map of variable (column) names to column coefficients (in varCoeffs)
+   UFFNameMap varCoeffMap;
+   std::vector<Constraint> varCoeffs;
 
    // UFFLP cut generation object
    UFFCutGenerator userCutGen;
 
-   // Flag that indicates that the current context is the cut generation
+   // Flag that indicates that the current context is the cut generation. As
+   // the flags below, it is only changed inside solve(), by the thread solving
+   // this problem, which is also the one that runs its callbacks
    bool generatingCuts;
 
-   // Pointer to the current cut collection
+   // Pointer to the current cut collection (valid while generatingCuts)
    OsiCuts* cutCollection;
 
    // UFFLP primal heuristic object
@@ -270,6 +409,9 @@ private:
    // Flag that indicates that the current context is the primal heuristic
    bool inHeuristic;
 
+   // User's data for the callbacks (see setCallBackData)
+   void* callBackData;
+
    // Flag that indicates that a solution has been provided by the primal
    // heuristic
    bool newSolutionSet;
@@ -284,12 +426,38 @@ private:
    // where the objective sense is already known
    double cutoffValue;
 
+   // Initial incumbent set by the user for the next call to "solve" (empty if
+   // none)
+   std::vector<double> initialSolution;
+
+   // Column bounds and objective coefficients given by the user, when adding
+   // the variables or through changeBounds/changeObjCoeff. A branch-and-bound
+   // may leave in the solver bounds fixed from its own objective and cutoff,
+   // so these are applied again before every re-solve
+   std::vector<double> userColLb;
+   std::vector<double> userColUb;
+   std::vector<double> userObj;
+
    // Flag that indicates that the problem has at least one integer variable
    bool hasIntegerVar;
 
-   // Flag the indicates that the MIP problem has already been solved at least
-   // once
+   // Flag the indicates that the problem has already been solved at least
+   // once, and the number of variables at the last solve
    bool hasBeenSolved;
+   int solvedNumCols;
+
+   // Statistics of the last solve: seconds spent in synchronizeProblem and in
+   // the optimization itself, B&B nodes, LP iterations and relative gap
+   double syncSeconds;
+   double optimizeSeconds;
+   int solvedNodes;
+   int solvedIterations;
+   double solvedGap;
+
+   // Index of the UFFLP cut generator in the model (-1 if not added yet) and
+   // flag that indicates that the UFFLP primal heuristic has been added
+   int userCutGenIdx;
+   bool userHeurAdded;
 
    // Flag the indicates that the integer feasible solution may be infeasible
    // for the complete problem
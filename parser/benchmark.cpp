@@ -0,0 +1,139 @@
+#include "parser.h"
+#ifdef __LINUX__
+#include <sys/resource.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+//BENCHMARK (--benchmark N)
+//Roda N vezes o fluxo completo em cada instância de exemplo e em cada formulação do modelo, com o
+//horario.txt do diretório, e informa a mediana e o percentil 95 de cada fase e o pico de memória. Tudo é lido de arquivos
+//locais e o Cbc é determinístico, então duas rodadas na mesma máquina são comparáveis. Os tempos
+//incluem a gravação em disco do .lp, das grades e do mix.log, como numa execução normal
+
+static const char* instanciasBenchmark[] = {"instanciaLuan.json", "instanciaMateus.json", "instanciaNilbson.json"};
+
+//Fases medidas em cada execução (nomes de CronometroFase). solveY e solveX incluem a escrita
+//do .lp e das grades, que também aparecem sozinhas em escreveLP e escreveGrade
+static const char* fasesBenchmark[] = {"atualizaDados", "programacaoDinamica", "constroiModelo", "solveY",
+    "solveX", "escreveLP", "escreveGrade", "total"};
+#define NUM_FASES_BENCHMARK 8
+
+//Formulações comparadas em cada instância, com o nome usado no relatório
+static const Formulacao formulacoesBenchmark[] = {{CHOQUE_SLOT, PERIODOS_DESAGREGADO},
+    {CHOQUE_PARES, PERIODOS_DESAGREGADO}, {CHOQUE_SLOT, PERIODOS_AGREGADO}, {CHOQUE_PARES, PERIODOS_AGREGADO}};
+static const char* nomesFormulacao[] = {"choque=slot,periodos=desagregado", "choque=pares,periodos=desagregado",
+    "choque=slot,periodos=agregado", "choque=pares,periodos=agregado"};
+#define NUM_FORMULACOES_BENCHMARK 4
+
+//Descarta o que o parser imprime no cout durante as repetições
+struct SaidaNula : streambuf{
+    int overflow(int c){
+        return c;
+    }
+};
+
+//O log do Cbc e da UFFLP sem arquivo de log sai pelo stdout do C, que o cout não cobre: no Linux o
+//descritor 1 vai para /dev/null até restauraStdout. Retorna a cópia do descritor original (-1 se não
+//foi desviado)
+static int silenciaStdout(){
+#ifdef __LINUX__
+    fflush(stdout);
+    int original = dup(1);
+    int nulo = open("/dev/null", O_WRONLY);
+    if (original < 0 || nulo < 0){
+        if (original >= 0)
+            close(original);
+        if (nulo >= 0)
+            close(nulo);
+        return -1;
+    }
+    dup2(nulo, 1);
+    close(nulo);
+    return original;
+#else
+    return -1;
+#endif
+}
+
+static void restauraStdout(int original){
+#ifdef __LINUX__
+    if (original < 0)
+        return;
+    fflush(stdout);
+    dup2(original, 1);
+    close(original);
+#endif
+}
+
+//Valor na posição p (0 a 1) das amostras, pelo posto mais próximo
+static double percentil(vector<double> amostras, double p){
+    sort(amostras.begin(), amostras.end());
+    int k = (int)ceil(p * amostras.size()) - 1;
+    return amostras[max(k, 0)];
+}
+
+//Pico de memória residente do processo em kB (0 onde não é medido)
+static long picoMemoria(){
+#ifdef __LINUX__
+    struct rusage uso;
+    getrusage(RUSAGE_SELF, &uso);
+    return uso.ru_maxrss;
+#else
+    return 0;
+#endif
+}
+
+void executaBenchmark(int repeticoes){
+    json jBenchmark;
+    SaidaNula nula;
+    streambuf* saidaOriginal = cout.rdbuf();
+    cout << "Benchmark: " << repeticoes << " execucoes por instancia (tempos em ms; solveY, solveX e total "
+         << "incluem a gravacao do .lp, das grades e do mix.log)" << endl;
+
+    for (int n = 0; n < 3; n++)
+    for (int m = 0; m < NUM_FORMULACOES_BENCHMARK; m++){
+        const char* instancia = instanciasBenchmark[n];
+        const char* nomeFormulacao = nomesFormulacao[m];
+        vector< vector<double> > amostras(NUM_FASES_BENCHMARK);
+
+        //Uma execução de aquecimento fora das amostras (arquivos em cache, alocador)
+        cout.rdbuf(&nula);
+        int stdoutOriginal = silenciaStdout();
+        for (int r = 0; r <= repeticoes; r++){
+            Metricas metricas;
+            {
+                CronometroFase fase(&metricas, "total");
+                resolveAluno(instancia, false, NULL, "", &formulacoesBenchmark[m], &metricas);
+            }
+            if (r == 0)
+                continue;
+            for (int f = 0; f < NUM_FASES_BENCHMARK; f++)
+                amostras[f].push_back(tempoFase(&metricas, fasesBenchmark[f]) * 1000);
+        }
+        restauraStdout(stdoutOriginal);
+        cout.rdbuf(saidaOriginal);
+
+        cout << endl << instancia << " (" << nomeFormulacao << ")" << endl;
+        cout << setw(22) << left << "fase" << setw(12) << right << "mediana" << setw(12) << "p95" << endl;
+        for (int f = 0; f < NUM_FASES_BENCHMARK; f++){
+            double mediana = percentil(amostras[f], 0.5), p95 = percentil(amostras[f], 0.95);
+            cout << setw(22) << left << fasesBenchmark[f] << right << fixed << setprecision(3)
+                 << setw(12) << mediana << setw(12) << p95 << endl;
+            jBenchmark[instancia][nomeFormulacao]["fases"][fasesBenchmark[f]]["medianaMs"] = mediana;
+            jBenchmark[instancia][nomeFormulacao]["fases"][fasesBenchmark[f]]["p95Ms"] = p95;
+        }
+        cout.unsetf(ios::fixed);
+        cout << setprecision(6);
+
+        //O pico é do processo todo, então vale até esta instância e formulação
+        long pico = picoMemoria();
+        cout << "pico de memoria: " << pico << " kB" << endl;
+        jBenchmark[instancia][nomeFormulacao]["picoMemoriaKB"] = pico;
+        jBenchmark[instancia][nomeFormulacao]["execucoes"] = repeticoes;
+    }
+
+    ofstream jOutput("benchmark.json");
+    jOutput << setw(4) << jBenchmark << endl;
+    jOutput.close();
+}
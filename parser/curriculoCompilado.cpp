@@ -0,0 +1,270 @@
+#include "parser.h"
+#include <cstring>
+#ifdef __LINUX__
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+//CURRÍCULO COMPILADO (--compile-curriculum)
+//Imagem binária do Curriculo já montado, para começar sem ler json nem refazer o grafo de choque e os
+//pré-requisitos: um cabeçalho com versão e checksum seguido das seções, cada uma alinhada em 8 bytes e
+//na ordem de bytes da máquina que gravou. Ao carregar, o arquivo é mapeado (mmap) e os vetores do
+//currículo apontam direto para a imagem; só os textos (nome, horário e código) viram strings
+
+#define MAGICA_CURRICULO "SACICUR"
+#define VERSAO_CURRICULO 1
+
+enum SecaoCurriculo{
+    SECAO_IDENTIFICADOR,    //int[n]: chave no json de cada disciplina
+    SECAO_CREDITOS,         //int[n]
+    SECAO_OBRIGATORIA,      //int[n]: identificadorOb
+    SECAO_OPTATIVA,         //int[n]: identificadorOp
+    SECAO_PREREQ_INICIO,    //int[n+1]: pré-requisitos em CSR
+    SECAO_CLAUSULA_INICIO,  //int[numClausulas+1]
+    SECAO_CLAUSULA_MEMBRO,  //int[numMembros]
+    SECAO_CHOQUE_INICIO,    //int[n+1]: grafo de choque em CSR
+    SECAO_CHOQUE_VIZINHO,   //int[numVizinhos]
+    SECAO_HORARIO_BITS,     //MascaraHorario[n]
+    SECAO_TEXTO_INICIO,     //int[3n+1]: início do nome, do horário e do código de cada disciplina em SECAO_TEXTO
+    SECAO_TEXTO,            //char[]: tabela de textos
+    NUM_SECOES
+};
+
+struct CabecalhoCurriculo{
+    char magica[8];
+    uint32_t versao;
+    uint32_t checksum;           //FNV-1a dos bytes depois do cabeçalho
+    uint64_t tamanho;            //Tamanho do arquivo inteiro
+    int32_t disciplinas;
+    int32_t numDisciplinasOp;
+    uint64_t inicio[NUM_SECOES]; //Deslocamento de cada seção a partir do início do arquivo
+    uint64_t bytes[NUM_SECOES];
+};
+
+static uint32_t checksumImagem(const char* dados, size_t bytes){
+    uint32_t h = 2166136261u;
+    for (size_t k = 0; k < bytes; k++){
+        h ^= (unsigned char)dados[k];
+        h *= 16777619u;
+    }
+    return h;
+}
+
+//Acrescenta uma seção ao fim da imagem, alinhada em 8 bytes
+static void anexaSecao(vector<char>& imagem, CabecalhoCurriculo& cabecalho, int secao, const void* dados, size_t bytes){
+    imagem.resize((imagem.size() + 7) & ~(size_t)7, 0);
+    cabecalho.inicio[secao] = imagem.size();
+    cabecalho.bytes[secao] = bytes;
+    imagem.insert(imagem.end(), (const char*)dados, (const char*)dados + bytes);
+}
+
+//Grava o currículo no arquivo. Retorna falso se não conseguir escrever
+bool gravaCurriculo(const Curriculo* curriculo, const char* arquivo){
+    int n = curriculo->disciplinas;
+    int numClausulas = curriculo->preReqInicio[n];
+    int numMembros = curriculo->clausulaInicio[numClausulas];
+    int numVizinhos = curriculo->choqueInicio[n];
+
+    //Tabela de textos: nome, horário e código de cada disciplina (código vazio se não houver)
+    vector<string> codigo(n);
+    for (unordered_map<string, int>::const_iterator it = curriculo->indiceCodigo.begin(); it != curriculo->indiceCodigo.end(); ++it)
+        codigo[it->second] = it->first;
+    vector<int> textoInicio(3 * n + 1);
+    string texto;
+    for (int i = 0; i < n; i++){
+        textoInicio[3 * i] = texto.size();
+        texto += curriculo->nomeCadeira[i];
+        textoInicio[3 * i + 1] = texto.size();
+        texto += curriculo->horario[i];
+        textoInicio[3 * i + 2] = texto.size();
+        texto += codigo[i];
+    }
+    textoInicio[3 * n] = texto.size();
+
+    CabecalhoCurriculo cabecalho;
+    memset(&cabecalho, 0, sizeof(cabecalho));
+    memcpy(cabecalho.magica, MAGICA_CURRICULO, sizeof(cabecalho.magica));
+    cabecalho.versao = VERSAO_CURRICULO;
+    cabecalho.disciplinas = n;
+    cabecalho.numDisciplinasOp = curriculo->numDisciplinasOp;
+
+    vector<char> imagem(sizeof(cabecalho), 0);
+    anexaSecao(imagem, cabecalho, SECAO_IDENTIFICADOR, curriculo->identificador, n * sizeof(int));
+    anexaSecao(imagem, cabecalho, SECAO_CREDITOS, curriculo->creditos, n * sizeof(int));
+    anexaSecao(imagem, cabecalho, SECAO_OBRIGATORIA, curriculo->identificadorOb, n * sizeof(int));
+    anexaSecao(imagem, cabecalho, SECAO_OPTATIVA, curriculo->identificadorOp, n * sizeof(int));
+    anexaSecao(imagem, cabecalho, SECAO_PREREQ_INICIO, curriculo->preReqInicio, (n + 1) * sizeof(int));
+    anexaSecao(imagem, cabecalho, SECAO_CLAUSULA_INICIO, curriculo->clausulaInicio, (numClausulas + 1) * sizeof(int));
+    anexaSecao(imagem, cabecalho, SECAO_CLAUSULA_MEMBRO, curriculo->clausulaMembro, numMembros * sizeof(int));
+    anexaSecao(imagem, cabecalho, SECAO_CHOQUE_INICIO, curriculo->choqueInicio, (n + 1) * sizeof(int));
+    anexaSecao(imagem, cabecalho, SECAO_CHOQUE_VIZINHO, curriculo->choqueVizinho, numVizinhos * sizeof(int));
+    anexaSecao(imagem, cabecalho, SECAO_HORARIO_BITS, curriculo->horarioBits, n * sizeof(MascaraHorario));
+    anexaSecao(imagem, cabecalho, SECAO_TEXTO_INICIO, &textoInicio[0], textoInicio.size() * sizeof(int));
+    anexaSecao(imagem, cabecalho, SECAO_TEXTO, texto.data(), texto.size());
+
+    cabecalho.tamanho = imagem.size();
+    cabecalho.checksum = checksumImagem(&imagem[sizeof(cabecalho)], imagem.size() - sizeof(cabecalho));
+    memcpy(&imagem[0], &cabecalho, sizeof(cabecalho));
+
+    ofstream saida(arquivo, ios::out | ios::binary);
+    saida.write(&imagem[0], imagem.size());
+    saida.close();
+    return !saida.fail();
+}
+
+//Verdadeiro se o arquivo começa com a marca de um currículo compilado
+bool curriculoCompilado(const char* arquivo){
+    char magica[8] = {0};
+    ifstream entrada(arquivo, ios::in | ios::binary);
+    entrada.read(magica, sizeof(magica));
+    return entrada.gcount() == (streamsize)sizeof(magica) && memcmp(magica, MAGICA_CURRICULO, sizeof(magica)) == 0;
+}
+
+//Os inícios de um CSR (ou da tabela de textos), inicio[0] a inicio[linhas], precisam começar em zero e
+//nunca diminuir
+static bool iniciosOrdenados(const int* inicio, int linhas){
+    if (inicio[0] != 0)
+        return false;
+    for (int t = 0; t < linhas; t++)
+        if (inicio[t + 1] < inicio[t])
+            return false;
+    return true;
+}
+
+//Todos os índices do vetor precisam ser disciplinas, de 0 a disciplinas - 1
+static bool indicesDisciplina(const int* indice, int tamanho, int disciplinas){
+    for (int k = 0; k < tamanho; k++)
+        if (indice[k] < 0 || indice[k] >= disciplinas)
+            return false;
+    return true;
+}
+
+//Confere o cabeçalho, se cada seção cabe no arquivo com o tamanho esperado e se os CSR de pré-requisitos
+//e de choque só apontam para dentro das suas seções e para disciplinas existentes, para que quem percorre
+//o currículo nunca leia fora da imagem mesmo com um checksum correto
+static bool imagemValida(const char* imagem, size_t tamanho){
+    if (tamanho < sizeof(CabecalhoCurriculo))
+        return false;
+    const CabecalhoCurriculo* cabecalho = (const CabecalhoCurriculo*)imagem;
+    if (memcmp(cabecalho->magica, MAGICA_CURRICULO, sizeof(cabecalho->magica)) != 0 ||
+        cabecalho->versao != VERSAO_CURRICULO || cabecalho->tamanho != tamanho || cabecalho->disciplinas < 0)
+        return false;
+    for (int s = 0; s < NUM_SECOES; s++)
+        if (cabecalho->inicio[s] % 8 != 0 || cabecalho->inicio[s] > tamanho || cabecalho->bytes[s] > tamanho - cabecalho->inicio[s])
+            return false;
+    if (checksumImagem(imagem + sizeof(CabecalhoCurriculo), tamanho - sizeof(CabecalhoCurriculo)) != cabecalho->checksum)
+        return false;
+
+    uint64_t n = cabecalho->disciplinas;
+    const int* preReqInicio = (const int*)(imagem + cabecalho->inicio[SECAO_PREREQ_INICIO]);
+    const int* clausulaInicio = (const int*)(imagem + cabecalho->inicio[SECAO_CLAUSULA_INICIO]);
+    const int* choqueInicio = (const int*)(imagem + cabecalho->inicio[SECAO_CHOQUE_INICIO]);
+    const int* textoInicio = (const int*)(imagem + cabecalho->inicio[SECAO_TEXTO_INICIO]);
+    if (cabecalho->bytes[SECAO_IDENTIFICADOR] != n * sizeof(int) || cabecalho->bytes[SECAO_CREDITOS] != n * sizeof(int) ||
+        cabecalho->bytes[SECAO_OBRIGATORIA] != n * sizeof(int) || cabecalho->bytes[SECAO_OPTATIVA] != n * sizeof(int) ||
+        cabecalho->bytes[SECAO_PREREQ_INICIO] != (n + 1) * sizeof(int) || cabecalho->bytes[SECAO_CHOQUE_INICIO] != (n + 1) * sizeof(int) ||
+        cabecalho->bytes[SECAO_HORARIO_BITS] != n * sizeof(MascaraHorario) || cabecalho->bytes[SECAO_TEXTO_INICIO] != (3 * n + 1) * sizeof(int))
+        return false;
+
+    //Cada seção de inícios é conferida antes de usar seu último valor como tamanho da seguinte
+    if (!iniciosOrdenados(preReqInicio, n) ||
+        cabecalho->bytes[SECAO_CLAUSULA_INICIO] != (uint64_t)(preReqInicio[n] + 1) * sizeof(int))
+        return false;
+    int numClausulas = preReqInicio[n];
+    if (!iniciosOrdenados(clausulaInicio, numClausulas) ||
+        cabecalho->bytes[SECAO_CLAUSULA_MEMBRO] != (uint64_t)clausulaInicio[numClausulas] * sizeof(int))
+        return false;
+    const int* clausulaMembro = (const int*)(imagem + cabecalho->inicio[SECAO_CLAUSULA_MEMBRO]);
+    if (!indicesDisciplina(clausulaMembro, clausulaInicio[numClausulas], n))
+        return false;
+    if (!iniciosOrdenados(choqueInicio, n) ||
+        cabecalho->bytes[SECAO_CHOQUE_VIZINHO] != (uint64_t)choqueInicio[n] * sizeof(int))
+        return false;
+    const int* choqueVizinho = (const int*)(imagem + cabecalho->inicio[SECAO_CHOQUE_VIZINHO]);
+    if (!indicesDisciplina(choqueVizinho, choqueInicio[n], n))
+        return false;
+    return iniciosOrdenados(textoInicio, 3 * n) && cabecalho->bytes[SECAO_TEXTO] == (uint64_t)textoInicio[3 * n];
+}
+
+//Carrega um currículo gravado por gravaCurriculo. Os vetores numéricos apontam para a imagem mapeada,
+//que fica com o currículo até destroiCurriculo. Retorna falso se o arquivo não existe ou não confere
+bool carregaCurriculo(Curriculo* curriculo, const char* arquivo){
+    char* imagem = NULL;
+    size_t tamanho = 0;
+#ifdef __LINUX__
+    int fd = open(arquivo, O_RDONLY);
+    if (fd < 0)
+        return false;
+    struct stat info;
+    if (fstat(fd, &info) == 0 && info.st_size > 0){
+        tamanho = info.st_size;
+        void* mapa = mmap(NULL, tamanho, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (mapa != MAP_FAILED)
+            imagem = (char*)mapa;
+    }
+    close(fd);
+    if (imagem == NULL)
+        return false;
+#else
+    ifstream entrada(arquivo, ios::in | ios::binary | ios::ate);
+    if (!entrada)
+        return false;
+    tamanho = entrada.tellg();
+    imagem = new char[tamanho];
+    entrada.seekg(0);
+    entrada.read(imagem, tamanho);
+#endif
+    if (!imagemValida(imagem, tamanho)){
+        cout << "Curriculo compilado invalido ou de outra versao: " << arquivo << endl;
+#ifdef __LINUX__
+        munmap(imagem, tamanho);
+#else
+        delete[] imagem;
+#endif
+        return false;
+    }
+
+    const CabecalhoCurriculo* cabecalho = (const CabecalhoCurriculo*)imagem;
+    int n = cabecalho->disciplinas;
+    curriculo->imagem = imagem;
+    curriculo->tamanhoImagem = tamanho;
+    curriculo->disciplinas = n;
+    curriculo->numDisciplinasOp = cabecalho->numDisciplinasOp;
+    curriculo->identificador = (int*)(imagem + cabecalho->inicio[SECAO_IDENTIFICADOR]);
+    curriculo->creditos = (int*)(imagem + cabecalho->inicio[SECAO_CREDITOS]);
+    curriculo->identificadorOb = (int*)(imagem + cabecalho->inicio[SECAO_OBRIGATORIA]);
+    curriculo->identificadorOp = (int*)(imagem + cabecalho->inicio[SECAO_OPTATIVA]);
+    curriculo->preReqInicio = (int*)(imagem + cabecalho->inicio[SECAO_PREREQ_INICIO]);
+    curriculo->clausulaInicio = (int*)(imagem + cabecalho->inicio[SECAO_CLAUSULA_INICIO]);
+    curriculo->clausulaMembro = (int*)(imagem + cabecalho->inicio[SECAO_CLAUSULA_MEMBRO]);
+    curriculo->choqueInicio = (int*)(imagem + cabecalho->inicio[SECAO_CHOQUE_INICIO]);
+    curriculo->choqueVizinho = (int*)(imagem + cabecalho->inicio[SECAO_CHOQUE_VIZINHO]);
+    curriculo->horarioBits = (MascaraHorario*)(imagem + cabecalho->inicio[SECAO_HORARIO_BITS]);
+
+    //Textos da tabela
+    const int* textoInicio = (const int*)(imagem + cabecalho->inicio[SECAO_TEXTO_INICIO]);
+    const char* texto = imagem + cabecalho->inicio[SECAO_TEXTO];
+    curriculo->nomeCadeira = new string[n];
+    curriculo->horario = new string[n];
+    curriculo->indiceCodigo.clear();
+    curriculo->indiceCodigo.reserve(n);
+    for (int i = 0; i < n; i++){
+        curriculo->nomeCadeira[i].assign(texto + textoInicio[3 * i], textoInicio[3 * i + 1] - textoInicio[3 * i]);
+        curriculo->horario[i].assign(texto + textoInicio[3 * i + 1], textoInicio[3 * i + 2] - textoInicio[3 * i + 1]);
+        if (textoInicio[3 * i + 3] > textoInicio[3 * i + 2])
+            curriculo->indiceCodigo[string(texto + textoInicio[3 * i + 2], textoInicio[3 * i + 3] - textoInicio[3 * i + 2])] = i;
+    }
+    return true;
+}
+
+//Libera a imagem de um currículo carregado por carregaCurriculo
+void liberaImagemCurriculo(Curriculo* curriculo){
+#ifdef __LINUX__
+    munmap(curriculo->imagem, curriculo->tamanhoImagem);
+#else
+    delete[] curriculo->imagem;
+#endif
+    curriculo->imagem = NULL;
+}
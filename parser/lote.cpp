@@ -0,0 +1,161 @@
+#include "parser.h"
+#ifdef __LINUX__
+#include <dirent.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#endif
+
+//LOTE (--batch)
+//Resolve os alunos de uma turma num só processo: o currículo (horario.txt e dados do curso) é montado
+//uma vez e de cada aluno só se lê a situação. Cada aluno grava suas saídas com o prefixo
+//DIR/<instância>. (grades, .lp, mix.log, log.txt com a saída do solver e metrics.json). Com
+//--workers N > 1 os alunos são divididos entre N processos filhos, que herdam o currículo já montado.
+//Os trabalhadores são processos e não threads: não foi verificado se o Cbc aceita resolver problemas
+//diferentes ao mesmo tempo (ver a nota em UFFLP.h), e o desvio do cout e o stdout onde o Cbc escreve o
+//log são do processo todo. As métricas e o contexto da heurística já são de cada resolução
+
+//Nome do arquivo sem diretório e sem a extensão .json
+static string nomeBase(const string& caminho){
+    size_t barra = caminho.find_last_of("/\\");
+    string nome = (barra == string::npos) ? caminho : caminho.substr(barra + 1);
+    if (nome.size() > 5 && nome.compare(nome.size() - 5, 5, ".json") == 0)
+        nome.erase(nome.size() - 5);
+    return nome;
+}
+
+//Arquivos de instância: os .json do diretório, em ordem alfabética, ou as linhas da lista
+static vector<string> listaInstancias(const char* entrada){
+    vector<string> instancias;
+#ifdef __LINUX__
+    DIR* dir = opendir(entrada);
+    if (dir != NULL){
+        for (struct dirent* e = readdir(dir); e != NULL; e = readdir(dir)){
+            string nome = e->d_name;
+            if (nome.size() > 5 && nome.compare(nome.size() - 5, 5, ".json") == 0)
+                instancias.push_back(string(entrada) + "/" + nome);
+        }
+        closedir(dir);
+        sort(instancias.begin(), instancias.end());
+        return instancias;
+    }
+#endif
+    ifstream lista(entrada, ios::in);
+    string linha;
+    while (getline(lista, linha)){
+        if (!linha.empty() && linha[linha.size() - 1] == '\r')
+            linha.erase(linha.size() - 1);
+        if (!linha.empty())
+            instancias.push_back(linha);
+    }
+    return instancias;
+}
+
+//Monta o currículo de um currículo compilado (--compile-curriculum) ou de uma instância json com o
+//horario.txt. As linhas do horario.txt seguem a ordem de uma exportação do SIGAA, então a instância
+//deve ser essa; os alunos são ligados ao currículo pelo código, em qualquer ordem
+bool abreCurriculo(Curriculo* curriculo, const char* arquivo){
+    if (curriculoCompilado(arquivo))
+        return carregaCurriculo(curriculo, arquivo);
+    ifstream entrada(arquivo, ios::in);
+    json j;
+    try{
+        entrada >> j;
+    }catch (const exception&){
+        return false;
+    }
+    Horarios horarios;
+    leHorarios(&horarios, "horario.txt");
+    ostringstream descarte; //A listagem das disciplinas não interessa aqui
+    streambuf* saidaOriginal = cout.rdbuf(descarte.rdbuf());
+    leCurriculo(curriculo, j, &horarios);
+    cout.rdbuf(saidaOriginal);
+    return true;
+}
+
+//Monta o currículo do lote com a primeira das fontes que puder ser lida
+static bool montaCurriculoLote(Curriculo* curriculo, const vector<string>& fontes){
+    for (size_t k = 0; k < fontes.size(); k++){
+        if (abreCurriculo(curriculo, fontes[k].c_str())){
+            cout << "Curriculo lido de " << fontes[k] << ": " << curriculo->disciplinas << " disciplinas" << endl;
+            return true;
+        }
+    }
+    return false;
+}
+
+//Resolve um aluno do lote com a saída do solver desviada para o log dele e informa o resultado
+static void resolveDoLote(const string& instancia, const Curriculo* curriculo, const char* diretorioSaida,
+                          const Formulacao* formulacao){
+    string prefixo = string(diretorioSaida) + "/" + nomeBase(instancia) + ".";
+    ofstream log((prefixo + "log.txt").c_str());
+    streambuf* saidaOriginal = cout.rdbuf(log.rdbuf());
+    Metricas metricas;
+    bool ok = true;
+    try{
+        CronometroFase fase(&metricas, "total");
+        resolveAluno(instancia.c_str(), false, curriculo, prefixo, formulacao, &metricas);
+    }catch (const exception& e){ //Instância mal formada: registra no log e segue com os outros
+        cout << "Erro ao resolver " << instancia << ": " << e.what() << endl;
+        ok = false;
+    }
+    cout.rdbuf(saidaOriginal);
+    log.close();
+    gravaMetricas(&metricas, (prefixo + "metrics.json").c_str());
+    cout << instancia << (ok ? ": ok em " : ": erro em ") << tempoFase(&metricas, "total") << " s" << endl;
+}
+
+//arquivoCurriculo é o currículo compilado ou a instância de onde ele vem, ou NULL para usar a primeira
+//instância do lote
+void executaLote(const char* entrada, const char* diretorioSaida, int trabalhadores, const char* arquivoCurriculo,
+                 const Formulacao* formulacao){
+    vector<string> instancias = listaInstancias(entrada);
+    trabalhadores = min(trabalhadores, (int)instancias.size());
+    cout << "Lote com " << instancias.size() << " alunos" << endl;
+    Curriculo curriculo;
+    vector<string> fontes = instancias;
+    if (arquivoCurriculo != NULL)
+        fontes.assign(1, arquivoCurriculo);
+    if (!montaCurriculoLote(&curriculo, fontes)){
+        cout << "Nenhuma instancia pode ser lida para montar o curriculo" << endl;
+        return;
+    }
+
+#ifdef __LINUX__
+    //Fila de trabalho num pipe: o pai escreve os índices e cada filho lê o próximo quando termina
+    //um aluno (leituras de um int são atômicas), então os alunos demorados não atrasam os demais
+    int fila[2];
+    if (trabalhadores > 1 && pipe(fila) == 0){
+        cout.flush();
+        vector<pid_t> filhos;
+        for (int w = 0; w < trabalhadores; w++){
+            pid_t pid = fork();
+            if (pid == 0){
+                close(fila[1]);
+                int k;
+                while (read(fila[0], &k, sizeof(k)) == (ssize_t)sizeof(k))
+                    resolveDoLote(instancias[k], &curriculo, diretorioSaida, formulacao);
+                cout.flush();
+                _exit(0);
+            }
+            if (pid > 0)
+                filhos.push_back(pid);
+        }
+        close(fila[0]);
+        if (!filhos.empty()){
+            for (int k = 0; k < (int)instancias.size(); k++)
+                if (write(fila[1], &k, sizeof(k)) != (ssize_t)sizeof(k))
+                    break;
+            close(fila[1]);
+            for (size_t w = 0; w < filhos.size(); w++)
+                waitpid(filhos[w], NULL, 0);
+            destroiCurriculo(&curriculo);
+            return;
+        }
+        close(fila[1]); //Nenhum filho criado: resolve tudo aqui mesmo
+    }
+#endif
+
+    for (size_t k = 0; k < instancias.size(); k++)
+        resolveDoLote(instancias[k], &curriculo, diretorioSaida, formulacao);
+    destroiCurriculo(&curriculo);
+}
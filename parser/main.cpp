@@ -1,9 +1,196 @@
 #include "parser.h"
 
-int main (){
+//Resolve o aluno já lido em data e grava as grades; data é liberado no fim
+void resolveDados(Data* data, bool soHeuristica){
+    Modelo modelo;
+    if (soHeuristica){
+        CronometroFase fase(data->metricas, "heuristica");
+        solveHeuristica(data);
+        destroiDados(data);
+        return;
+    }
+
+    //Poucas pendentes: programação dinâmica exata; senão (ou se ela desistir), o MIP em duas etapas
+    {
+        CronometroFase fase(data->metricas, "programacaoDinamica");
+        if (solvePD(data)){
+            destroiDados(data);
+            return;
+        }
+    }
+    {
+        CronometroFase fase(data->metricas, "constroiModelo");
+        constroiModelo(data, &modelo);
+    }
+    {
+        CronometroFase fase(data->metricas, "solveY");
+        solveCoin_Y(data, &modelo);
+    }
+    {
+        CronometroFase fase(data->metricas, "solveX");
+        solveCoin(data, &modelo);
+    }
+    destroiModelo(&modelo);
+    destroiDados(data);
+}
+
+//Troca as formulações padrão de montaDados pelas escolhidas (nada muda se formulacao for NULL)
+void aplicaFormulacao(Data* data, const Formulacao* formulacao){
+    if (formulacao == NULL)
+        return;
+    data->formulacaoChoque = formulacao->choque;
+    data->formulacaoPeriodos = formulacao->periodos;
+}
+
+//Resolve um aluno do início ao fim, da leitura da instância à gravação das grades. curriculo é o
+//currículo já montado (NULL para montar a partir da instância), prefixoSaida vai na frente dos
+//arquivos gravados, formulacao escolhe as formulações do modelo (NULL para as padrão) e metricas
+//recebe os tempos e contadores (NULL para não medir)
+void resolveAluno(const char* instancia, bool soHeuristica, const Curriculo* curriculo, const string& prefixoSaida,
+                  const Formulacao* formulacao, Metricas* metricas){
     Data data;
-    atualizaDados(&data);
-    solveCoin_Y(&data);
-    solveCoin(&data);
+    {
+        CronometroFase fase(metricas, "atualizaDados");
+        atualizaDados(&data, instancia, curriculo);
+    }
+    data.prefixoSaida = prefixoSaida;
+    data.metricas = metricas;
+    aplicaFormulacao(&data, formulacao);
+    resolveDados(&data, soHeuristica);
+}
+
+//Verdadeiro se o argumento é um número inteiro (com sinal opcional)
+static bool ehInteiro(const char* argumento){
+    char* fim;
+    strtol(argumento, &fim, 10);
+    return fim != argumento && *fim == '\0';
+}
+
+int main (int argc, char* argv[]){
+    //--heuristic-only: responde só com a grade gulosa, sem resolver o modelo
+    //--benchmark [N]: roda N (por padrão 10) vezes cada instância de exemplo e grava benchmark.json
+    //--batch ENTRADA [--workers N] [--output DIR]: resolve os alunos de um diretório (todos os .json) ou
+    //de uma lista (um arquivo por linha), gravando as saídas de cada um em DIR
+    //--curriculum ARQ: currículo compilado ou instância de onde ele é montado (no lote, por padrão, a
+    //primeira instância; fora dele, a própria instância do aluno)
+    //--compile-curriculum INSTANCIA SAIDA: grava o currículo da instância (e do horario.txt) em SAIDA
+    //--serve SOCKET [--workers N]: atende pedidos no socket Unix com o currículo de --curriculum (por
+    //padrão, o da instanciaNilbson.json) carregado uma vez
+    //--choque pares|slot: formulação das restrições de choque (padrão slot)
+    //--periodos desagregado|agregado: formulação da ligação de X com Y (padrão desagregado)
+    //O benchmark roda todas as combinações das duas
+    bool soHeuristica = false;
+    int repeticoes = 0, trabalhadores = 1;
+    const char* lote = NULL;
+    const char* diretorioSaida = ".";
+    const char* arquivoCurriculo = NULL;
+    const char* compilaEntrada = NULL;
+    const char* compilaSaida = NULL;
+    const char* socketServidor = NULL;
+    Formulacao formulacao = {CHOQUE_SLOT, PERIODOS_DESAGREGADO};
+    for (int a = 1; a < argc; a++){
+        if (string(argv[a]) == "--heuristic-only")
+            soHeuristica = true;
+        else if (string(argv[a]) == "--benchmark"){
+            //N é opcional: só consome o próximo argumento se ele for um número
+            repeticoes = 10;
+            if (a + 1 < argc && ehInteiro(argv[a + 1])){
+                repeticoes = atoi(argv[++a]);
+                if (repeticoes <= 0){
+                    cout << "--benchmark: o numero de execucoes deve ser positivo" << endl;
+                    return 1;
+                }
+            }
+        }
+        else if (string(argv[a]) == "--batch" && a + 1 < argc)
+            lote = argv[++a];
+        else if (string(argv[a]) == "--workers" && a + 1 < argc)
+            trabalhadores = max(1, atoi(argv[++a]));
+        else if (string(argv[a]) == "--output" && a + 1 < argc)
+            diretorioSaida = argv[++a];
+        else if (string(argv[a]) == "--curriculum" && a + 1 < argc)
+            arquivoCurriculo = argv[++a];
+        else if (string(argv[a]) == "--serve" && a + 1 < argc)
+            socketServidor = argv[++a];
+        else if (string(argv[a]) == "--choque" && a + 1 < argc){
+            string valor = argv[++a];
+            if (valor == "pares")
+                formulacao.choque = CHOQUE_PARES;
+            else if (valor == "slot")
+                formulacao.choque = CHOQUE_SLOT;
+            else{
+                cout << "--choque: use pares ou slot" << endl;
+                return 1;
+            }
+        }
+        else if (string(argv[a]) == "--periodos" && a + 1 < argc){
+            string valor = argv[++a];
+            if (valor == "desagregado")
+                formulacao.periodos = PERIODOS_DESAGREGADO;
+            else if (valor == "agregado")
+                formulacao.periodos = PERIODOS_AGREGADO;
+            else{
+                cout << "--periodos: use desagregado ou agregado" << endl;
+                return 1;
+            }
+        }
+        else if (string(argv[a]) == "--compile-curriculum" && a + 2 < argc){
+            compilaEntrada = argv[++a];
+            compilaSaida = argv[++a];
+        }
+    }
+    if (compilaEntrada != NULL){
+        Curriculo curriculo;
+        if (!abreCurriculo(&curriculo, compilaEntrada)){
+            cout << "Nao foi possivel ler o curriculo de " << compilaEntrada << endl;
+            return 1;
+        }
+        bool gravou = gravaCurriculo(&curriculo, compilaSaida);
+        destroiCurriculo(&curriculo);
+        if (!gravou){
+            cout << "Nao foi possivel gravar " << compilaSaida << endl;
+            return 1;
+        }
+        cout << "Curriculo compilado em " << compilaSaida << endl;
+        return 0;
+    }
+    if (socketServidor != NULL){
+        Curriculo curriculo;
+        const char* fonte = (arquivoCurriculo != NULL) ? arquivoCurriculo : "instanciaNilbson.json";
+        if (!abreCurriculo(&curriculo, fonte)){
+            cout << "Nao foi possivel ler o curriculo de " << fonte << endl;
+            return 1;
+        }
+        executaServidor(socketServidor, trabalhadores, &curriculo, &formulacao);
+        destroiCurriculo(&curriculo);
+        return 0;
+    }
+    if (repeticoes > 0){
+        executaBenchmark(repeticoes);
+        return 0;
+    }
+    if (lote != NULL){
+        executaLote(lote, diretorioSaida, trabalhadores, arquivoCurriculo, &formulacao);
+        return 0;
+    }
+
+    Metricas metricas;
+    {
+        CronometroFase fase(&metricas, "total");
+        Curriculo curriculo;
+        const Curriculo* compartilhado = NULL;
+        if (arquivoCurriculo != NULL){
+            CronometroFase faseCurriculo(&metricas, "abreCurriculo");
+            if (!abreCurriculo(&curriculo, arquivoCurriculo)){
+                cout << "Nao foi possivel ler o curriculo de " << arquivoCurriculo << endl;
+                return 1;
+            }
+            compartilhado = &curriculo;
+        }
+        resolveAluno("instanciaNilbson.json", soHeuristica, compartilhado, "", &formulacao, &metricas);
+        if (compartilhado != NULL)
+            destroiCurriculo(&curriculo);
+    }
+    gravaMetricas(&metricas, "metrics.json");
     return 0;
-}
\ No newline at end of file
+}
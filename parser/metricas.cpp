@@ -0,0 +1,69 @@
+#include "parser.h"
+
+//MÉTRICAS DA EXECUÇÃO
+//Tempo acumulado por fase (com o número de vezes que ela rodou) e contadores do modelo e do Cbc,
+//gravados ao final em metrics.json para acompanhar regressões entre currículos. Ficam no Metricas
+//de cada resolução (Data::metricas); com NULL nada é registrado
+
+CronometroFase::CronometroFase(Metricas* metricas, const string& fase)
+    : metricas(metricas), fase(fase), inicio(chrono::steady_clock::now()){
+}
+
+CronometroFase::~CronometroFase(){
+    registraTempo(metricas, fase, chrono::duration<double>(chrono::steady_clock::now() - inicio).count());
+}
+
+void registraTempo(Metricas* metricas, const string& fase, double segundos){
+    if (metricas == NULL)
+        return;
+    TempoFase& t = metricas->temposFase[fase]; //Começa zerado na primeira vez
+    t.segundos += segundos;
+    t.chamadas++;
+}
+
+void registraContador(Metricas* metricas, const string& nome, double valor){
+    if (metricas != NULL)
+        metricas->contadores[nome] = valor;
+}
+
+//Segundos acumulados na fase (zero se ela não rodou)
+double tempoFase(const Metricas* metricas, const string& fase){
+    unordered_map<string, TempoFase>::const_iterator it = metricas->temposFase.find(fase);
+    return it == metricas->temposFase.end() ? 0 : it->second.segundos;
+}
+
+//Tamanho do modelo e estatísticas da última resolução, como "etapa.linhas", "etapa.nos" etc.
+//O tempo de sincronização e o de otimização (relaxação e branch-and-bound) entram como fases
+void registraSolve(Metricas* metricas, const string& etapa, UFFProblem* prob){
+    if (metricas == NULL)
+        return;
+    static const UFFLP_InfoType tipos[] = {UFFLP_NumRows, UFFLP_NumCols, UFFLP_NumNonzeros,
+        UFFLP_NodeCount, UFFLP_IterationCount, UFFLP_RelativeGap};
+    static const char* nomes[] = {"linhas", "colunas", "naoNulos", "nos", "iteracoesLP", "gap"};
+    double valor;
+    for (int k = 0; k < 6; k++)
+        if (UFFLP_GetSolveInfo(prob, tipos[k], &valor) == UFFLP_Ok)
+            registraContador(metricas, etapa + "." + nomes[k], valor);
+    if (UFFLP_GetSolveInfo(prob, UFFLP_SyncTime, &valor) == UFFLP_Ok)
+        registraTempo(metricas, etapa + ".sincronizacao", valor);
+    if (UFFLP_GetSolveInfo(prob, UFFLP_OptimizeTime, &valor) == UFFLP_Ok)
+        registraTempo(metricas, etapa + ".branchAndBound", valor);
+}
+
+//Grava {"fases": {"fase": {"segundos": s, "chamadas": n}}, "contadores": {"nome": valor}}
+void gravaMetricas(const Metricas* metricas, const char* arquivo){
+    json jMetricas;
+    jMetricas["fases"] = json::object();
+    jMetricas["contadores"] = json::object();
+    for (unordered_map<string, TempoFase>::const_iterator it = metricas->temposFase.begin();
+         it != metricas->temposFase.end(); ++it){
+        jMetricas["fases"][it->first]["segundos"] = it->second.segundos;
+        jMetricas["fases"][it->first]["chamadas"] = it->second.chamadas;
+    }
+    for (unordered_map<string, double>::const_iterator it = metricas->contadores.begin();
+         it != metricas->contadores.end(); ++it)
+        jMetricas["contadores"][it->first] = it->second;
+    ofstream jOutput(arquivo);
+    jOutput << setw(4) << jMetricas << endl;
+    jOutput.close();
+}
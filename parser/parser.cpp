@@ -1,47 +1,276 @@
 #include "parser.h"
 
-void atualizaDados(Data* data){
-    ifstream arquivoAluno("instanciaNilbson.json", ios::in); // Abre instância com dados do aluno
-    ifstream arquivoHorario("horario.txt", ios::in); // Abre instância com horários das disciplinas
-    string horario1;
-    
-    json j; //Cria objeto da classe json para iterar os dados do aluno
-    arquivoAluno >> j; // Transfere informações da instância para objeto do json
+//Retorna o índice denso da disciplina com a chave do json (ou o código) informado, ou -1 se ela não
+//tiver horário
+template <class Chave>
+static int indiceDe(const unordered_map<Chave, int>& tabela, const Chave& chave){
+    typename unordered_map<Chave, int>::const_iterator pos = tabela.find(chave);
+    return (pos == tabela.end()) ? -1 : pos->second;
+}
 
-    int discUteis = -1;
-    while (horario1 != "end"){ //Loop que identifica quantidade de disciplinas úteis
-        arquivoHorario >> horario1; //Transfere informações dos horários para objeto do json
-        if (horario1 == "0"){
-            continue;
-        }    
-        ++discUteis;
+//Decodifica um horário do SIGAA (ex.: "35M23", "24T45", "35N346N1") em slots ocupados.
+//Cada grupo é formado por dias, turno (M, T ou N) e aulas. Quando grupos vêm colados, as aulas
+//de um grupo são consecutivas, então o primeiro dígito que quebra a sequência já é dia do próximo.
+//Grupos também podem vir separados por espaços (ex.: "2M23 4T45", "24M23 35T23").
+MascaraHorario decodificaHorario(const string& codigo){
+    MascaraHorario mascara = {{0, 0}};
+    size_t p = 0, n = codigo.size();
+
+    while (p < n){
+        while (p < n && isspace((unsigned char)codigo[p]))
+            p++;
+        if (p == n)
+            break;
+        size_t inicioDias = p;
+        while (p < n && isdigit(codigo[p]))
+            p++;
+        if (p == n)
+            break;
+
+        int turno;
+        switch (codigo[p]){
+            case 'M': turno = 0; break;
+            case 'T': turno = 1; break;
+            case 'N': turno = 2; break;
+            default: return mascara; //Código fora do padrão, mantém o que já foi lido
+        }
+        size_t fimDias = p++;
+
+        int primeiraAula = 0, numAulas = 0;
+        while (p < n && isdigit(codigo[p])){
+            int aula = codigo[p] - '0';
+            if (aula < 1 || aula > AULAS_TURNO || (numAulas > 0 && aula != primeiraAula + numAulas))
+                break;
+            if (numAulas == 0)
+                primeiraAula = aula;
+            numAulas++;
+            p++;
+        }
+        //Sequência engoliu o dia do próximo grupo (ex.: "2M345T12"), devolve o último dígito. Só quando
+        //vem um turno logo depois: antes de um espaço ou do fim, todos os dígitos são aulas
+        if (p < n && (codigo[p] == 'M' || codigo[p] == 'T' || codigo[p] == 'N') && p == fimDias + 1 + numAulas &&
+            numAulas > 1 && codigo[p-1] - '0' >= 2){
+            numAulas--;
+            p--;
+        }
+
+        for (size_t d = inicioDias; d < fimDias; d++){
+            int dia = codigo[d] - '2';
+            if (dia < 0 || dia >= DIAS_SEMANA)
+                continue;
+            for (int a = 0; a < numAulas; a++){
+                int slot = (dia * TURNOS + turno) * AULAS_TURNO + (primeiraAula - 1 + a);
+                mascara.bits[slot >> 6] |= (uint64_t)1 << (slot & 63);
+            }
+        }
+    }
+    return mascara;
+}
+
+//Monta o grafo de choque (CSR) agrupando as disciplinas por slot ocupado: cada disciplina só visita
+//quem divide algum slot com ela, então o custo cresce com o número de choques e não com n².
+static void montaGrafoChoque(Curriculo* curriculo){
+    int n = curriculo->disciplinas;
+
+    //Disciplinas de cada slot, agrupadas por contagem
+    int *slotInicio = new int[SLOTS_HORARIO + 1];
+    for (int s = 0; s <= SLOTS_HORARIO; s++)
+        slotInicio[s] = 0;
+    for (int i = 0; i < n; i++)
+        for (int s = 0; s < SLOTS_HORARIO; s++)
+            if ((curriculo->horarioBits[i].bits[s >> 6] >> (s & 63)) & 1)
+                slotInicio[s + 1]++;
+    for (int s = 0; s < SLOTS_HORARIO; s++)
+        slotInicio[s + 1] += slotInicio[s];
+
+    int *slotDisciplina = new int[slotInicio[SLOTS_HORARIO]];
+    int *proximo = new int[SLOTS_HORARIO];
+    for (int s = 0; s < SLOTS_HORARIO; s++)
+        proximo[s] = slotInicio[s];
+    for (int i = 0; i < n; i++)
+        for (int s = 0; s < SLOTS_HORARIO; s++)
+            if ((curriculo->horarioBits[i].bits[s >> 6] >> (s & 63)) & 1)
+                slotDisciplina[proximo[s]++] = i;
+
+    //Vizinhos de cada disciplina, sem repetição (marca com o índice da disciplina visitada)
+    vector<int> inicio(n + 1, 0), vizinho;
+    vector<int> marca(n, -1);
+    for (int i = 0; i < n; i++){
+        marca[i] = i;
+        if (mascaraVazia(curriculo->horarioBits[i])){ //Horário não reconhecido, só choca com o mesmo texto
+            for (int k = 0; k < n; k++)
+                if (marca[k] != i && mascaraVazia(curriculo->horarioBits[k]) && curriculo->horario[i] == curriculo->horario[k]){
+                    marca[k] = i;
+                    vizinho.push_back(k);
+                }
+        }else{
+            for (int s = 0; s < SLOTS_HORARIO; s++){
+                if (!((curriculo->horarioBits[i].bits[s >> 6] >> (s & 63)) & 1))
+                    continue;
+                for (int p = slotInicio[s]; p < slotInicio[s + 1]; p++){
+                    int k = slotDisciplina[p];
+                    if (marca[k] != i){
+                        marca[k] = i;
+                        vizinho.push_back(k);
+                    }
+                }
+            }
+        }
+        inicio[i + 1] = vizinho.size();
+    }
+
+    curriculo->choqueInicio = new int[n + 1];
+    curriculo->choqueVizinho = new int[vizinho.size() + 1];
+    copy(inicio.begin(), inicio.end(), curriculo->choqueInicio);
+    copy(vizinho.begin(), vizinho.end(), curriculo->choqueVizinho);
+
+    delete[] slotInicio;
+    delete[] slotDisciplina;
+    delete[] proximo;
+}
+
+//PRÉ-REQUISITOS DO SIGAA, ex.: "( ( 1103177 E 1107248 ) OU GDINF0107 )"
+//Gramática: expr := termo { OU termo }, termo := fator { E fator }, fator := ( expr ) | código.
+//A expressão é compilada em forma normal conjuntiva: todas as cláusulas (E) precisam ser atendidas,
+//e cada cláusula é atendida por qualquer uma de suas disciplinas (OU). Lista vazia = sem pré-requisito.
+typedef vector<vector<int> > FormaCNF;
+
+struct LeitorPreRequisito{
+    vector<string> tokens;
+    size_t pos;
+    const unordered_map<string, int>* indiceCodigo;
+    bool erro;
+};
+
+static void tokenizaPreRequisito(const string& expr, vector<string>& tokens){
+    size_t p = 0, n = expr.size();
+    while (p < n){
+        if (isspace((unsigned char)expr[p])){
+            p++;
+        }else if (expr[p] == '(' || expr[p] == ')'){
+            tokens.push_back(string(1, expr[p++]));
+        }else{
+            size_t inicio = p;
+            while (p < n && !isspace((unsigned char)expr[p]) && expr[p] != '(' && expr[p] != ')')
+                p++;
+            tokens.push_back(expr.substr(inicio, p - inicio));
+        }
+    }
+}
+
+//a OU b: cada cláusula do resultado junta uma cláusula de a com uma de b
+static FormaCNF ouCNF(const FormaCNF& a, const FormaCNF& b){
+    FormaCNF r;
+    if (a.empty() || b.empty()) //Um dos lados já está atendido
+        return r;
+    for (size_t x = 0; x < a.size(); x++){
+        for (size_t y = 0; y < b.size(); y++){
+            vector<int> clausula(a[x]);
+            clausula.insert(clausula.end(), b[y].begin(), b[y].end());
+            sort(clausula.begin(), clausula.end());
+            clausula.erase(unique(clausula.begin(), clausula.end()), clausula.end());
+            r.push_back(clausula);
+        }
+    }
+    return r;
+}
+
+static FormaCNF leExpressaoPreReq(LeitorPreRequisito& leitor);
+
+static FormaCNF leFatorPreReq(LeitorPreRequisito& leitor){
+    FormaCNF r;
+    if (leitor.pos >= leitor.tokens.size()){
+        leitor.erro = true;
+        return r;
+    }
+    const string& token = leitor.tokens[leitor.pos++];
+    if (token == "("){
+        r = leExpressaoPreReq(leitor);
+        if (leitor.pos < leitor.tokens.size() && leitor.tokens[leitor.pos] == ")")
+            leitor.pos++;
+        else
+            leitor.erro = true;
+    }else if (token == ")" || token == "E" || token == "OU"){
+        leitor.erro = true;
+    }else{
+        //Código fora da grade (sem horário) conta como atendido
+        unordered_map<string, int>::const_iterator k = leitor.indiceCodigo->find(token);
+        if (k != leitor.indiceCodigo->end())
+            r.push_back(vector<int>(1, k->second));
+    }
+    return r;
+}
+
+static FormaCNF leTermoPreReq(LeitorPreRequisito& leitor){
+    FormaCNF r = leFatorPreReq(leitor);
+    while (!leitor.erro && leitor.pos < leitor.tokens.size() && leitor.tokens[leitor.pos] == "E"){
+        leitor.pos++;
+        FormaCNF b = leFatorPreReq(leitor);
+        r.insert(r.end(), b.begin(), b.end());
+    }
+    return r;
+}
+
+static FormaCNF leExpressaoPreReq(LeitorPreRequisito& leitor){
+    FormaCNF r = leTermoPreReq(leitor);
+    while (!leitor.erro && leitor.pos < leitor.tokens.size() && leitor.tokens[leitor.pos] == "OU"){
+        leitor.pos++;
+        r = ouCNF(r, leTermoPreReq(leitor));
+    }
+    return r;
+}
+
+//Compila a expressão de pré-requisito em cláusulas de índices densos. Em expressão mal formada
+//avisa e considera a disciplina sem pré-requisito
+static FormaCNF compilaPreRequisito(const string& expr, const unordered_map<string, int>& indiceCodigo){
+    LeitorPreRequisito leitor;
+    leitor.pos = 0;
+    leitor.indiceCodigo = &indiceCodigo;
+    leitor.erro = false;
+    tokenizaPreRequisito(expr, leitor.tokens);
+    if (leitor.tokens.empty())
+        return FormaCNF();
+
+    FormaCNF r = leExpressaoPreReq(leitor);
+    if (leitor.erro || leitor.pos != leitor.tokens.size()){
+        cout << "Pre-requisito mal formado, ignorado: " << expr << endl;
+        return FormaCNF();
+    }
+    return r;
+}
+
+//Lê o horario.txt: um horário por disciplina da instância, "0" nas sem horário, até "end".
+//Só as disciplinas com horário são guardadas, com a posição (chave no json) de cada uma
+void leHorarios(Horarios* horarios, const char* arquivo){
+    ifstream arquivoHorario(arquivo, ios::in); // Abre instância com horários das disciplinas
+    string horario;
+    horarios->identificador.clear();
+    horarios->horario.clear();
+    for (int temp = 0; arquivoHorario >> horario && horario != "end"; temp++){
+        if (horario != "0"){
+            horarios->identificador.push_back(temp);
+            horarios->horario.push_back(horario); //Armazena horarios p/ criação da matriz choque de horario
+        }
     }
     arquivoHorario.close();
+}
 
-    //Fazendo segunda parte
+//Lê os dados do curso (tudo menos a situação do aluno) de uma instância já aberta, com os horários
+//do catálogo. O currículo é somente leitura depois de montado e pode ser usado por vários alunos
+void leCurriculo(Curriculo* curriculo, json& j, const Horarios* horarios){
+    int discUteis = horarios->horario.size();
     string *horario = new string[discUteis]; //Variável que armazena todos os horários
-    ifstream arquivoHorario2("horario.txt", ios::in); // Abre instância com horários das disciplinas
-    string horario2;
-    
     int *identificador = new int[discUteis];
-    int k = 0, temp = 0;
-    while (horario2 != "end"){ //Loop que identifica quantidade de disciplinas úteis
-        arquivoHorario2 >> horario2;
-        
-        if (horario2 != "0" && horario2 != "end"){
-            identificador[k] = temp;
-            horario[k] = horario2; //Armazena horarios p/ criação da matriz choque de horario
-            k++;
-        }
-        temp++;
+    for (int k = 0; k < discUteis; k++){
+        identificador[k] = horarios->identificador[k];
+        horario[k] = horarios->horario[k];
     }
-    data->horario = horario;
+    curriculo->horario = horario;
 
     //OPTATIVAS - SEPARANDO AS OBRIGATÓRIAS E CONTANDO O NÚMERO DE OPTATIVAS
     int *identificadorOp = new int[discUteis];
     int *identificadorOb = new int[discUteis];
     int numOptativas = 0;
-    int qntCreditoOpPago = 0;
 
     for(int i = 0; i < discUteis; i++)
         identificadorOb[i] = 0;
@@ -49,739 +278,878 @@ void atualizaDados(Data* data){
         identificadorOp[i] = 0;
 
 
+    //TABELA CHAVE DO JSON -> ÍNDICE DENSO, CONSTRUÍDA UMA ÚNICA VEZ
+    //Todas as seções do json são indexadas pela mesma chave, então cada leitura abaixo é O(1)
+    unordered_map<int, int> indiceDisciplina;
+    indiceDisciplina.reserve(discUteis);
+    for (int i = 0; i < discUteis; i++)
+        indiceDisciplina[identificador[i]] = i;
+
     for (json::iterator it = j["tipoIntegralizacao"].begin(); it != j["tipoIntegralizacao"].end(); ++it){
         int i = atoi(it.key().data());
-        
-        //Organiza dados de acordo com os pre requisitos
-        int retorno = 0, iTemp = 0;
-        while (iTemp < discUteis){
-            if (identificador[iTemp] == i){
-                if (it.value() == "OP"){
-                    identificadorOp[iTemp] = i;
-                    numOptativas++;
-                    break;
-                }else{
-                    identificadorOb[iTemp] = i;
-                    break;
-                }
-            }
-            iTemp++;
+        int iTemp = indiceDe(indiceDisciplina, i);
+        if (iTemp < 0) //Disciplina sem horário
+            continue;
+
+        if (it.value() == "OP"){
+            identificadorOp[iTemp] = i;
+            numOptativas++;
+        }else{
+            identificadorOb[iTemp] = i;
         }
     }
 //------------------------------------------------------------------------------------------------------
     //Iterando json e armazenando Qnt. de créditos de cada cadeira
     int *credito = new int[discUteis];
     for (json::iterator it = j["cargaHoraria"].begin(); it != j["cargaHoraria"].end(); ++it) {
-        int i = atoi(it.key().data());
-        
-        //Organiza dados de acordo com os que tem horário
-        int retorno = 0, iTemp = 0;
-        while (iTemp < discUteis){
-            if (identificador[iTemp] == i){
-                credito[iTemp] = it.value();
-                credito[iTemp] /= 15;
-            }
-            iTemp++;
-        }
-    }
-
-    //Iterando json e armazenando situacao (concluido = 1 ou pendente = 0)
-    int *situacao = new int[discUteis];
-    for (int i = 0; i < discUteis; i++){
-        situacao[i] = 0;
-    }
+        int iTemp = indiceDe(indiceDisciplina, atoi(it.key().data()));
+        if (iTemp < 0)
+            continue;
 
-    for (json::iterator it = j["situacao"].begin(); it != j["situacao"].end(); ++it) {
-        int i = atoi(it.key().data());
-        
-        //Organiza dados de acordo com os que tem horário
-        int retorno = 0, iTemp = 0;
-        while (iTemp < discUteis){
-            if (identificador[iTemp] == i && (it.value() == "CONCLUIDO")){
-                situacao[iTemp] = 1;
-
-                if (identificadorOp[iTemp] == i){
-                    qntCreditoOpPago += credito[iTemp];
-                }
-            }
-            iTemp++;
-        }
+        credito[iTemp] = it.value();
+        credito[iTemp] /= 15;
     }
-    cout << "QUANTIDADE DE OPTATIVAS PAGAS: " << qntCreditoOpPago << endl;
 
     //ARMAZENA OS NOMES DAS CADEIRAS P/ USAR NO JSON DE SAÍDA DEPOIS DE RODAR O MODELO
     string *nomeTemp = new string[discUteis];
     for (json::iterator it = j["nome"].begin(); it != j["nome"].end(); ++it) {
-        int i = atoi(it.key().data());
-        
-        //Organiza dados de acordo com os que tem horário
-        int retorno = 0, iTemp = 0;
-        while (iTemp < discUteis){
-            if (identificador[iTemp] == i){
-                nomeTemp[iTemp] = it.value();
-            }
-            iTemp++;
-        }
-    }
+        int iTemp = indiceDe(indiceDisciplina, atoi(it.key().data()));
+        if (iTemp < 0)
+            continue;
 
-    //CRIA E PREENCHE MATRIZ DE CHOQUE DE HORÁRIOS
-    bool choqueHorario[discUteis][discUteis]; //Armazena se tem choque de horario ou não
-    for (int i = 0; i < discUteis; i++){
-        for (int j = 0; j < discUteis; j++){
-            if (horario[i] == horario[j])
-                choqueHorario[i][j] = true;
-            else
-                choqueHorario[i][j] = false;
-        }
+        nomeTemp[iTemp] = it.value();
     }
 
-    //CRIA E PREENCHE MATRIZ DE PRE REQUISITOS
-    int preReqI[discUteis][discUteis];//Matriz de pre requisitos
+    //CODIFICA OS HORÁRIOS EM SLOTS P/ DETECTAR SOBREPOSIÇÃO (ex.: "35M23" e "3M2" chocam)
+    MascaraHorario *horarioBits = new MascaraHorario[discUteis];
     for (int i = 0; i < discUteis; i++){
-        for (int j = 0; j < discUteis; j++){
-            preReqI[i][j] = 0;
-        }
+        horarioBits[i] = decodificaHorario(horario[i]);
     }
+    curriculo->horarioBits = horarioBits;
 
-    string preRequisito[discUteis][3]; //Lista de pre requsitos
-    for (int i = 0; i < discUteis; i++){ //Zera essa lista
-        for(int j = 0; j < 3; j++){
-            preRequisito[i][j] = "0";
-        }
+    //TABELA CÓDIGO DA DISCIPLINA -> ÍNDICE DENSO (apenas disciplinas com horário)
+    unordered_map<string, int>& indiceCodigo = curriculo->indiceCodigo;
+    indiceCodigo.clear();
+    indiceCodigo.reserve(discUteis);
+    for (json::iterator it = j["codigo"].begin(); it != j["codigo"].end(); ++it){
+        int iTemp = indiceDe(indiceDisciplina, atoi(it.key().data()));
+        if (iTemp >= 0)
+            indiceCodigo[it.value()] = iTemp;
     }
 
+    //COMPILA AS EXPRESSÕES DE PRÉ-REQUISITO NO GRAFO EM CSR: DISCIPLINA -> CLÁUSULAS -> DISCIPLINAS
+    vector<FormaCNF> preRequisito(discUteis);
+    int numClausulas = 0, numMembros = 0;
     for (json::iterator it = j["expressaoPreRequisito"].begin(); it != j["expressaoPreRequisito"].end(); ++it){
-        int i = atoi(it.key().data());
-        
-        //Organiza dados de acordo com os pre requisitos
-        int retorno = 0, iTemp = 0;
-        while (iTemp < discUteis){
-            if (identificador[iTemp] == i){
-                retorno = 1;
-                break;
-            }
-            iTemp++;
-        }
-
-        if (it.value() == nullptr)
+        int iTemp = indiceDe(indiceDisciplina, atoi(it.key().data()));
+        if (iTemp < 0 || it.value() == nullptr)
             continue;
-        //Passa para proxima iteração caso seja null
-        /*if (it.value() == nullptr){ 
-            preRequisito[iTemp] = "0";
-            continue;
-        }*/
 
-        //Depois que encontrou pre requisito, armazena na string
-        if (retorno == 1){
-            preRequisito[iTemp][0] = it.value();
-        }
+        preRequisito[iTemp] = compilaPreRequisito(it.value().get<string>(), indiceCodigo);
+        numClausulas += preRequisito[iTemp].size();
+        for (size_t c = 0; c < preRequisito[iTemp].size(); c++)
+            numMembros += preRequisito[iTemp][c].size();
     }
-    
-    //TRATA STRING PRE REQUISITO PARA ITERAR EM CODIGO
-    for (int i = 0; i < discUteis; i++){
-        if (preRequisito[i][0].size() == 1) //Se for null retorna 1
-            continue;
-
-        if (preRequisito[i][0].size() == 12){ //Apaga inicio e fim para filtrar código
-            preRequisito[i][0].erase(preRequisito[i][0].begin(), preRequisito[i][0].end()-10);
-            preRequisito[i][0].erase(preRequisito[i][0].end()-3, preRequisito[i][0].end());
-        }
 
-        if (preRequisito[i][0].size() == 14){ //Apaga inicio e fim para filtrar código
-            preRequisito[i][0].erase(preRequisito[i][0].begin(), preRequisito[i][0].end()-12);
-            preRequisito[i][0].erase(preRequisito[i][0].end()-3, preRequisito[i][0].end());
-        }
-
-        if (preRequisito[i][0].size() == 26){ //Apaga inicio e fim para filtrar código
-            preRequisito[i][1] = preRequisito[i][0];
-            preRequisito[i][0].erase(preRequisito[i][0].begin(), preRequisito[i][0].end()-22);
-            preRequisito[i][0].erase(preRequisito[i][0].end()-15, preRequisito[i][0].end());
-            preRequisito[i][1].erase(preRequisito[i][1].begin(), preRequisito[i][1].end()-12);
-            preRequisito[i][1].erase(preRequisito[i][1].end()-5, preRequisito[i][1].end());
-        }
-
-        if (preRequisito[i][0].size() == 28){ //Apaga inicio e fim para filtrar código
-            preRequisito[i][1] = preRequisito[i][0];
-            preRequisito[i][0].erase(preRequisito[i][0].begin(), preRequisito[i][0].end()-24);
-            preRequisito[i][0].erase(preRequisito[i][0].end()-15, preRequisito[i][0].end());
-            if (preRequisito[i][0].at(8) == 'E'){
-                preRequisito[i][0].erase(preRequisito[i][0].end()-2, preRequisito[i][0].end());
-            }
-            preRequisito[i][1].erase(preRequisito[i][1].begin(), preRequisito[i][1].end()-14);
-            preRequisito[i][1].erase(preRequisito[i][1].end()-5, preRequisito[i][1].end());
-            if (preRequisito[i][1].at(0) == 'E'){
-                preRequisito[i][1].erase(preRequisito[i][1].begin(), preRequisito[i][1].end()-7);
-            }
+    curriculo->preReqInicio = new int[discUteis + 1];
+    curriculo->clausulaInicio = new int[numClausulas + 1];
+    curriculo->clausulaMembro = new int[numMembros];
+    int c = 0, m = 0;
+    for (int i = 0; i < discUteis; i++){
+        curriculo->preReqInicio[i] = c;
+        for (size_t q = 0; q < preRequisito[i].size(); q++){
+            curriculo->clausulaInicio[c++] = m;
+            for (size_t k = 0; k < preRequisito[i][q].size(); k++)
+                curriculo->clausulaMembro[m++] = preRequisito[i][q][k];
         }
+    }
+    curriculo->preReqInicio[discUteis] = c;
+    curriculo->clausulaInicio[c] = m;
 
-        if (preRequisito[i][0].size() == 30){ //Apaga inicio e fim para filtrar código
-            preRequisito[i][1] = preRequisito[i][0];
-            preRequisito[i][0].erase(preRequisito[i][0].begin(), preRequisito[i][0].end()-26);
-            preRequisito[i][0].erase(preRequisito[i][0].end()-17, preRequisito[i][0].end());
-            preRequisito[i][1].erase(preRequisito[i][1].begin(), preRequisito[i][1].end()-14);
-            preRequisito[i][1].erase(preRequisito[i][1].end()-5, preRequisito[i][1].end());
-        }
 
-        if (preRequisito[i][0].size() == 36){ //Apaga inicio e fim para filtrar código
-            preRequisito[i][1] = preRequisito[i][0];
-            preRequisito[i][2] = preRequisito[i][0];
-            preRequisito[i][0].erase(preRequisito[i][0].begin(), preRequisito[i][0].end()-34);
-            preRequisito[i][0].erase(preRequisito[i][0].end()-27, preRequisito[i][0].end());
-            preRequisito[i][1].erase(preRequisito[i][1].begin(), preRequisito[i][1].end()-24);
-            preRequisito[i][1].erase(preRequisito[i][1].end()-15, preRequisito[i][1].end());
-            preRequisito[i][2].erase(preRequisito[i][2].begin(), preRequisito[i][2].end()-12);
-            preRequisito[i][2].erase(preRequisito[i][2].end()-3, preRequisito[i][2].end());
-        }
+    //Atribuição dos dados que serão utilizados no modelo p/ a struct
+    curriculo->nomeCadeira = nomeTemp;
+    curriculo->creditos = credito;
+    curriculo->identificador = identificador;
+    curriculo->disciplinas = discUteis;
+    curriculo->numDisciplinasOp = numOptativas;
+    curriculo->identificadorOb = identificadorOb;
+    curriculo->identificadorOp = identificadorOp;
+    curriculo->imagem = NULL;
+    curriculo->tamanhoImagem = 0;
+
+    montaGrafoChoque(curriculo);
 
-        if (preRequisito[i][0].size() == 42){ //Apaga inicio e fim para filtrar código
-            preRequisito[i][1] = preRequisito[i][0];
-            preRequisito[i][2] = preRequisito[i][0];
-            preRequisito[i][0].erase(preRequisito[i][0].begin(), preRequisito[i][0].end()-38);
-            preRequisito[i][0].erase(preRequisito[i][0].end()-29, preRequisito[i][0].end());
-            preRequisito[i][1].erase(preRequisito[i][1].begin(), preRequisito[i][1].end()-26);
-            preRequisito[i][1].erase(preRequisito[i][1].end()-17, preRequisito[i][1].end());
-            preRequisito[i][2].erase(preRequisito[i][2].begin(), preRequisito[i][2].end()-14);
-            preRequisito[i][2].erase(preRequisito[i][2].end()-5, preRequisito[i][2].end());
-        }
+    //Print genérico para visualizar se o parser exibe valores certos
+    for (int i = 0; i < discUteis; i++){
+        cout << i << " : " << identificador[i] << endl;
     }
+}
 
-    //TRATA MATRIZ PRE REQUISITOS PARA TRANSFORMAR STRING EM IDENTIFICADOR
-    int preReqIdentificador[discUteis][discUteis];
-    for (int i = 0; i < discUteis; i++){ // Inicializa com requisito padrão
-        for(int j = 0; j < discUteis; j++){
-            preReqIdentificador[i][j] = 0;
-        }
+//Lê a situação do aluno (concluido = 1 ou pendente = 0) e os créditos de optativas que faltam. Cada
+//disciplina da instância é achada no currículo pelo código, então a ordem das linhas pode mudar de
+//um aluno para outro; códigos fora do currículo são ignorados
+void leEstadoAluno(EstadoAluno* estado, const Curriculo* curriculo, json& j){
+    int discUteis = curriculo->disciplinas;
+    int qntCreditoOpPago = 0;
+    int *situacao = new int[discUteis];
+    for (int i = 0; i < discUteis; i++){
+        situacao[i] = 0;
     }
 
-    for (json::iterator it = j["codigo"].begin(); it != j["codigo"].end(); ++it){
-        int i = atoi(it.key().data());
-            
-        //Organiza dados de acordo com os pre requisitos
-        int iTemp = 0, posicao = 0;
-    
-        while (iTemp < discUteis){
-            //cout << iTemp << "OI" << endl;
-            for(int j = 0; j < 3; j++){
-                //cout << preRequisito[iTemp][j] << "Ola galera" << endl;
-                if(preRequisito[iTemp][j].compare(it.value()) == 0){
-                    //cout << "Ola  " << " " << preRequisito[iTemp] << " " << it.value() << " " << iTemp << " " << i << endl;
-                    //cout << preRequisito[iTemp][identificador[i]] << " " << it << endl;
-                    for(k = 0; k < discUteis; k++){
-                        if(identificador[k] == i){
-                            posicao = k;
-                        }
-                    }
-                    preReqIdentificador[iTemp][posicao] = i;
-                    //cout << i << " - "<< preRequisito[iTemp][j] << " " << " " << it.value() << " "  << " j: "  << j << " " << preRequisito[iTemp][identificador[i]] << " " << i << " itemp: " << iTemp  << " identificador" << identificador[i] << endl;
-                }
-            }
+    json& codigo = j["codigo"];
+    for (json::iterator it = j["situacao"].begin(); it != j["situacao"].end(); ++it) {
+        if (it.value() != "CONCLUIDO")
+            continue;
+        json::iterator cod = codigo.find(it.key());
+        if (cod == codigo.end() || !cod->is_string())
+            continue;
+        int iTemp = indiceDe(curriculo->indiceCodigo, cod->get<string>());
+        if (iTemp < 0)
+            continue;
 
-            iTemp++;                                                                            
+        situacao[iTemp] = 1;
+        if (curriculo->identificadorOp[iTemp] == curriculo->identificador[iTemp]){
+            qntCreditoOpPago += curriculo->creditos[iTemp];
         }
     }
-    
+    cout << "QUANTIDADE DE OPTATIVAS PAGAS: " << qntCreditoOpPago << endl;
 
-    /*for (int i = 0; i < discUteis; i++){
-        cout << i << " : " << preRequisito[i] << endl;
-    }*/
+    estado->situacao = situacao;
+    estado->numCreditosOp = 16 - qntCreditoOpPago; // De acordo com o sigaa p/ o curso de Engenharia de Computação
+}
 
-    //Atribuição dos dados que serão utilizados no modelo p/ a struct
-    data->nomeCadeira = nomeTemp;
-    data->creditos = credito;
-    data->identificador = identificador;
-    data->situacao = situacao;
-    data->disciplinas = discUteis;
+//Junta o currículo compartilhado e a situação do aluno na visão usada pelo pré-processamento e pelos
+//modelos. Os vetores do currículo não são copiados; a situação passa a pertencer a data
+void montaDados(Data* data, const Curriculo* curriculo, const EstadoAluno* estado){
+    data->curriculo = curriculo;
+    data->curriculoProprio = NULL;
+    data->identificador = curriculo->identificador;
+    data->nomeCadeira = curriculo->nomeCadeira;
+    data->creditos = curriculo->creditos;
+    data->preReqInicio = curriculo->preReqInicio;
+    data->clausulaInicio = curriculo->clausulaInicio;
+    data->clausulaMembro = curriculo->clausulaMembro;
+    data->choqueInicio = curriculo->choqueInicio;
+    data->choqueVizinho = curriculo->choqueVizinho;
+    data->identificadorOb = curriculo->identificadorOb;
+    data->identificadorOp = curriculo->identificadorOp;
+    data->horario = curriculo->horario;
+    data->horarioBits = curriculo->horarioBits;
+    data->disciplinas = curriculo->disciplinas;
+    data->numDisciplinasOp = curriculo->numDisciplinasOp;
+
+    data->situacao = estado->situacao;
+    data->numCreditosOp = estado->numCreditosOp;
     data->numPeriodos = 12;
-    data->numDisciplinasOp = numOptativas;
-    data->numCreditosOp = 16 - qntCreditoOpPago; // De acordo com o sigaa p/ o curso de Engenharia de Computação
-    data->identificadorOb = identificadorOb;
-    data->identificadorOp = identificadorOp;
+    data->formulacaoChoque = CHOQUE_SLOT;
+    data->formulacaoPeriodos = PERIODOS_DESAGREGADO;
+    data->saidaMemoria = NULL;
+    data->metricas = NULL;
+}
 
-    //Preenche matriz de choque de horário direto em i
-    data->choqueHorarioI = new bool*[data->disciplinas];
-    for (int i = 0; i < data->disciplinas; i++){
-        data->choqueHorarioI[i] = new bool[data->disciplinas];
-        for (int j = 0; j < data->disciplinas; j++){
-            data->choqueHorarioI[i][j] = choqueHorario[i][j];
-        }
-    }
+//Lê o aluno de uma instância. Com currículo (lote), só a situação é lida; sem currículo, ele é montado
+//a partir da própria instância e dos horários (lidos do horario.txt se horarios for NULL) e fica com data
+void atualizaDados(Data* data, const char* instancia, const Curriculo* curriculo, const Horarios* horarios){
+    ifstream arquivoAluno(instancia, ios::in); // Abre instância com dados do aluno
 
-    //Preenche matriz de pre-requisitos direto em i
-    for (int i = 0; i < discUteis; i++){
-        for (int j = 0; j < discUteis; j++){
-            for(int k = 0; k < discUteis; k++){
-                //cout << "i: " << i << " " << preReqIdentificador[i][j] << " ij " << identificador[k]<< endl;
-                if (preReqIdentificador[i][j] == identificador[k]){
-                    //cout << "*********************************************************************************************" << endl;
-                    preReqI[i][j] = preReqIdentificador[i][j];
-                    //cout << preReqI[i][j]  << " " << i << " " << j << "  Aquiiiiiiiiiiiiiiiiiiiiiiiiiiii" << endl;
-                    break;
-                }
-                else{
-                    //cout << "xxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxx" << endl;
-                    preReqI[i][j] = 0;
-                }
-                //cout << endl << "pr" << preReqI[29][38] << endl;
-            }
-            //cout << endl << "se" << preReqI[29][38] << endl;
+    json j; //Cria objeto da classe json para iterar os dados do aluno
+    arquivoAluno >> j; // Transfere informações da instância para objeto do json
+    arquivoAluno.close();
+    atualizaDadosJson(data, j, curriculo, horarios);
+}
+
+//Como atualizaDados, com a instância já lida (pedidos do servidor)
+void atualizaDadosJson(Data* data, json& j, const Curriculo* curriculo, const Horarios* horarios){
+    Curriculo* proprio = NULL;
+    if (curriculo == NULL){
+        //Sem catálogo já lido, lê o horario.txt do diretório atual
+        Horarios horariosArquivo;
+        if (horarios == NULL){
+            leHorarios(&horariosArquivo, "horario.txt");
+            horarios = &horariosArquivo;
         }
-        //cout << endl << "te" << preReqI[29][38] << endl;
+        proprio = new Curriculo;
+        leCurriculo(proprio, j, horarios);
+        curriculo = proprio;
     }
 
-    data->preReqI = new int*[data->disciplinas];
-    for (int i = 0; i < data->disciplinas; i++){
-        data->preReqI[i] = new int[data->disciplinas];
-        for (int j = 0; j < data->disciplinas; j++){
-            data->preReqI[i][j] = preReqI[i][j];
-        }
+    EstadoAluno estado;
+    leEstadoAluno(&estado, curriculo, j);
+    montaDados(data, curriculo, &estado);
+    data->curriculoProprio = proprio;
+}
+
+//Libera os vetores do currículo (ou, se veio de um currículo compilado, os textos e a imagem)
+void destroiCurriculo(Curriculo* curriculo){
+    if (curriculo->imagem != NULL){
+        delete[] curriculo->nomeCadeira;
+        delete[] curriculo->horario;
+        liberaImagemCurriculo(curriculo);
+        return;
     }
-    
-    //Print genérico para visualizar se o parser exibe valores certos
-    for (int i = 0; i < discUteis; i++){
-        cout << i << " : " << identificador[i] << endl;
+    delete[] curriculo->identificador;
+    delete[] curriculo->nomeCadeira;
+    delete[] curriculo->creditos;
+    delete[] curriculo->preReqInicio;
+    delete[] curriculo->clausulaInicio;
+    delete[] curriculo->clausulaMembro;
+    delete[] curriculo->choqueInicio;
+    delete[] curriculo->choqueVizinho;
+    delete[] curriculo->identificadorOb;
+    delete[] curriculo->identificadorOp;
+    delete[] curriculo->horario;
+    delete[] curriculo->horarioBits;
+}
+
+//Libera a situação do aluno e, se foi montado só para ele, o currículo
+void destroiDados(Data* data){
+    delete[] data->situacao;
+    if (data->curriculoProprio != NULL){
+        destroiCurriculo(data->curriculoProprio);
+        delete data->curriculoProprio;
+        data->curriculoProprio = NULL;
     }
-    
-    //Fecha arquivos
-    arquivoAluno.close();
-    arquivoHorario.close();
-    arquivoHorario2.close();
 }
-  
 
-void solveCoin(Data* data){
-    // Cria problema
-    cout << "NUMERO DE PERIDOSODASOJDASO CERTO?" << data->numPeriodos << endl;
-    UFFProblem* prob = UFFLP_CreateProblem();
+//PRÉ-PROCESSAMENTO DO NÚMERO DE PERÍODOS
 
-    // Cria variaveis X
-	string varName, consName;
-  	stringstream s;
+//Verdadeiro se a cláusula c já está atendida por alguma disciplina concluída
+static bool clausulaAtendida(Data* data, int c){
+    for (int m = data->clausulaInicio[c]; m < data->clausulaInicio[c + 1]; m++)
+        if (data->situacao[data->clausulaMembro[m]])
+            return true;
+    return false;
+}
 
-    for (int i = 0; i < data->disciplinas; i++) {
-        for (int j = 0; j < data->numPeriodos; j++) {
-                s.clear();
-                s << "X(" << i << "," << j << ")";
-                s >> varName;
-                UFFLP_AddVariable(prob, (char*)varName.c_str(), 0.0, 1.0, j, UFFLP_Binary);
+//Período mais cedo em que a disciplina pendente i pode ser cursada: cada cláusula não atendida
+//exige a alternativa que pode ser cursada mais cedo em algum período anterior
+static int inicioMaisCedo(Data* data, int i, int* inicio){
+    if (inicio[i] >= 0)
+        return inicio[i];
+    inicio[i] = 0; //Marca a visita, um ciclo nos pré-requisitos não trava a busca
+
+    int e = 0;
+    for (int c = data->preReqInicio[i]; c < data->preReqInicio[i + 1]; c++){
+        if (clausulaAtendida(data, c))
+            continue;
+        int menor = -1;
+        for (int m = data->clausulaInicio[c]; m < data->clausulaInicio[c + 1]; m++){
+            int k = inicioMaisCedo(data, data->clausulaMembro[m], inicio) + 1;
+            if (menor < 0 || k < menor)
+                menor = k;
         }
+        e = max(e, menor);
     }
+    inicio[i] = e;
+    return e;
+}
 
-    // Definindo FUNC Obj. Y
-    s.clear();
-    s << "Y";
-    s >> varName;
-    UFFLP_AddVariable(prob, (char*)varName.c_str(), 1.0, 10.0, 0, UFFLP_Integer);
-
-    //PRIMEIRA RESTRIÇÃO DO MODELO - LIMITE DE CRÉDITOS POR PERÍODO
-    for (int j = 0; j < data->numPeriodos; j++){
-        s.clear();
-        s << "LimCreditos_" << j;
-        s >> consName;
+//Calcula o período mais cedo de cada disciplina pendente (-1 nas concluídas)
+void calculaInicioMaisCedo(Data* data, int* inicio){
+    for (int i = 0; i < data->disciplinas; i++)
+        inicio[i] = -1;
+    for (int i = 0; i < data->disciplinas; i++)
+        if (!data->situacao[i])
+            inicioMaisCedo(data, i, inicio);
+}
 
-        for (int i = 0; i < data->disciplinas; i++){
-            if (!data->situacao[i]){
-                s.clear();
-                s << "X(" << i << "," << j << ")";
-                s >> varName;
-                UFFLP_SetCoefficient( prob, (char*)consName.c_str(),(char*)varName.c_str(), data->creditos[i]);   
-            }        
+//Limite inferior para Y (índice do último período usado): o maior entre a cadeia de pré-requisitos
+//pendentes mais longa de uma obrigatória, os períodos exigidos pelos créditos que faltam e o maior
+//número de obrigatórias pendentes disputando um mesmo slot
+int limiteInferiorY(Data* data){
+    int n = data->disciplinas;
+    int *inicio = new int[n];
+    calculaInicioMaisCedo(data, inicio);
+
+    //Obrigatórias pendentes que ocupam um mesmo slot chocam duas a duas: uma por período
+    vector<int> ocupacao(SLOTS_HORARIO, 0);
+    int cadeia = 0, creditos = max(data->numCreditosOp, 0), clique = 0;
+    for (int i = 0; i < n; i++){
+        if (!data->situacao[i] && data->identificadorOb[i] != 0){
+            cadeia = max(cadeia, inicio[i]);
+            creditos += data->creditos[i];
+            for (int t = 0; t < SLOTS_HORARIO; t++)
+                if ((data->horarioBits[i].bits[t / 64] >> (t % 64)) & 1)
+                    clique = max(clique, ++ocupacao[t]);
         }
-        UFFLP_AddConstraint( prob, (char*)consName.c_str(), LIMITE_CREDITOS, UFFLP_Less);
     }
+    delete[] inicio;
 
-    //SEGUNDA RESTRIÇÃO
-    for (int i = 0; i < data->disciplinas; i++){ // Usando número de disciplinas faltantes pois é a mesma quantidade de disciplinas obrigatórias
-        if(!data->situacao[i] && data->identificadorOb[i] != 0){
-            s.clear();
-            s << "Obrigatorias_" << i;
-            s >> consName;
-                for(int j = 0; j < data->numPeriodos; j++){
-                    s.clear();
-                    s << "X(" << i << "," << j << ")";
-                    s >> varName;
-                    UFFLP_SetCoefficient( prob, (char*)consName.c_str(),(char*)varName.c_str(), 1);
-                }
-            UFFLP_AddConstraint( prob, (char*)consName.c_str(), 1, UFFLP_Equal);
-        }
-    }
+    int periodosCreditos = (creditos + LIMITE_CREDITOS - 1) / LIMITE_CREDITOS;
+    return max(1, max(cadeia, max(periodosCreditos, clique) - 1));
+}
 
-    //TERCEIRA RESTRIÇÃO DO MODELO - obriga mínimo de créditos de optativas
-    s.clear();
-    s << "MinCreditoOptativas_";
-    s >> consName;
-    for (int i = 0; i < data->disciplinas; i++){
-        if(!data->situacao[i] && data->identificadorOp[i] != 0){
-            for (int j = 0; j < data->numPeriodos; j++){
-                s.clear();
-                s << "X(" << i << "," << j << ")";
-                s >> varName;
-                UFFLP_SetCoefficient( prob, (char*)consName.c_str(),(char*)varName.c_str(), data->creditos[i]);
-            }
+//Grade gulosa: escolhe as obrigatórias pendentes, as optativas que podem ser cursadas mais cedo até
+//completar os créditos e as alternativas de pré-requisito que faltarem. Depois preenche período a
+//período com as disponíveis, priorizando as que têm mais dependentes em cadeia e respeitando créditos
+//e choques. Guarda o período de cada disciplina em periodo (-1 se fora da grade) e retorna o último
+//período usado, ou -1 se não couber em numPeriodos. Se preferencia (por disciplina, ex.: soma dos X
+//da relaxação linear) for informada, as optativas e alternativas preferidas são escolhidas primeiro
+int escalonamentoGuloso(Data* data, int* periodo, const double* preferencia){
+    int n = data->disciplinas;
+    int P = data->numPeriodos;
+    int *inicio = new int[n];
+    calculaInicioMaisCedo(data, inicio);
+
+    //Seleção das disciplinas
+    vector<bool> escolhida(n, false);
+    for (int i = 0; i < n; i++)
+        escolhida[i] = !data->situacao[i] && data->identificadorOb[i] != 0;
+
+    //Optativas em ordem de disputa de slot com as obrigatórias e, no empate, de início mais cedo
+    vector<int> ocupacaoOb(SLOTS_HORARIO, 0), disputa(n, 0);
+    for (int i = 0; i < n; i++)
+        if (escolhida[i])
+            for (int t = 0; t < SLOTS_HORARIO; t++)
+                if ((data->horarioBits[i].bits[t / 64] >> (t % 64)) & 1)
+                    ocupacaoOb[t]++;
+    vector<int> optativas;
+    for (int i = 0; i < n; i++){
+        if (!data->situacao[i] && data->identificadorOp[i] != 0){
+            optativas.push_back(i);
+            for (int t = 0; t < SLOTS_HORARIO; t++)
+                if ((data->horarioBits[i].bits[t / 64] >> (t % 64)) & 1)
+                    disputa[i] = max(disputa[i], ocupacaoOb[t]);
         }
     }
-    UFFLP_AddConstraint(prob, (char*)consName.c_str(), data->numCreditosOp, UFFLP_Greater);
-    
+    auto antes = [&](int x, int y){
+        if (preferencia != NULL && fabs(preferencia[x] - preferencia[y]) > 1e-6)
+            return preferencia[x] > preferencia[y];
+        if (disputa[x] != disputa[y])
+            return disputa[x] < disputa[y];
+        return inicio[x] < inicio[y];
+    };
+    for (size_t a = 1; a < optativas.size(); a++) //Poucas optativas, inserção basta
+        for (size_t b = a; b > 0 && antes(optativas[b], optativas[b - 1]); b--)
+            swap(optativas[b], optativas[b - 1]);
+    int creditosOp = 0;
+    for (size_t a = 0; a < optativas.size() && creditosOp < data->numCreditosOp; a++){
+        escolhida[optativas[a]] = true;
+        creditosOp += data->creditos[optativas[a]];
+    }
+    if (creditosOp < data->numCreditosOp){ //Nem todas as optativas completam os créditos
+        delete[] inicio;
+        return -1;
+    }
 
-    //QUARTA RESTRIÇÃO- PAGA OP APENAS UMA VEZ POR PERÍODO
-    for (int i = 0; i < data->disciplinas; i++){ // Usando número de disciplinas faltantes pois é a mesma quantidade de disciplinas obrigatórias
-        if (!data->situacao[i] && data->identificadorOp[i] != 0){
-            s.clear();
-            s << "OpUmaVez_" << i;
-            s >> consName;
-            for(int j = 0; j < data->numPeriodos; j++){
-                s.clear();
-                s << "X(" << i << "," << j << ")";
-                s >> varName;
-                UFFLP_SetCoefficient( prob, (char*)consName.c_str(),(char*)varName.c_str(), 1);
+    //Fecha a seleção: toda cláusula não atendida de uma escolhida precisa de uma alternativa escolhida
+    for (bool mudou = true; mudou;){
+        mudou = false;
+        for (int i = 0; i < n; i++){
+            if (!escolhida[i])
+                continue;
+            for (int c = data->preReqInicio[i]; c < data->preReqInicio[i + 1]; c++){
+                if (clausulaAtendida(data, c))
+                    continue;
+                int melhor = -1;
+                bool temEscolhida = false;
+                for (int m = data->clausulaInicio[c]; m < data->clausulaInicio[c + 1]; m++){
+                    int k = data->clausulaMembro[m];
+                    if (escolhida[k])
+                        temEscolhida = true;
+                    if (melhor < 0 || (preferencia != NULL && preferencia[k] > preferencia[melhor] + 1e-6) ||
+                        ((preferencia == NULL || fabs(preferencia[k] - preferencia[melhor]) <= 1e-6) && inicio[k] < inicio[melhor]))
+                        melhor = k;
+                }
+                if (!temEscolhida){
+                    escolhida[melhor] = true;
+                    mudou = true;
+                }
             }
         }
-        UFFLP_AddConstraint(prob, (char*)consName.c_str(), 1, UFFLP_Less);
     }
 
-    //QUINTA RESTRIÇÃO - PRE-REQUISITOS
-    for (int i = 0; i < data->disciplinas; i++){
-        if(!data->situacao[i]){
-            for (int k = 0; k < data->disciplinas; k++){
-                if (data->preReqI[i][k] != 0){
-                    s.clear();
-                    s << "PreReq_" << i << "_" << k;
-                    s >> consName;
-
-                    for(int j = 0; j < data->numPeriodos; j++){
-                        s.clear();
-                        s << "X(" << i << "," << j << ")";
-                        s >> varName;
-                        UFFLP_SetCoefficient( prob, (char*)consName.c_str(),(char*)varName.c_str(), j);
-            
-                        s.clear();
-                        s << "X(" << k << "," << j << ")";
-                        s >> varName;
-                        UFFLP_SetCoefficient( prob, (char*)consName.c_str(),(char*)varName.c_str(), -j);
+    //Altura: tamanho da maior cadeia de escolhidas que dependem de cada disciplina
+    vector<int> altura(n, 0);
+    for (int iter = 0; iter < n; iter++){
+        bool mudou = false;
+        for (int i = 0; i < n; i++){
+            if (!escolhida[i])
+                continue;
+            for (int c = data->preReqInicio[i]; c < data->preReqInicio[i + 1]; c++){
+                for (int m = data->clausulaInicio[c]; m < data->clausulaInicio[c + 1]; m++){
+                    int k = data->clausulaMembro[m];
+                    if (altura[k] < altura[i] + 1){
+                        altura[k] = altura[i] + 1;
+                        mudou = true;
                     }
-                    UFFLP_AddConstraint( prob, (char*)consName.c_str(), 1, UFFLP_Greater);
                 }
             }
         }
+        if (!mudou)
+            break;
     }
 
-    
-    //SEXTA RESTRIÇÃO
-    for(int j = 0; j < data->numPeriodos; j++){
-        for(int i = 0; i < data->disciplinas; i++){
-            if(!data->situacao[i]){
-                for(int k = 0; k < data->disciplinas; k++){
-                    if ((data->choqueHorarioI[i][k] == true) && (i != k)){
-                        s.clear();
-                        s << "Choq_Horario_" << j << "_" << i << "_" << k;
-                        s >> consName;
-
-                        s.clear();
-                        s << "X(" << k << "," << j << ")";
-                        s >> varName;
-                        UFFLP_SetCoefficient( prob, (char*)consName.c_str(),(char*)varName.c_str(), 1);
-
-                        s.clear();
-                        s << "X(" << i << "," << j << ")";
-                        s >> varName;
-                        UFFLP_SetCoefficient( prob, (char*)consName.c_str(),(char*)varName.c_str(), 1);
-                        UFFLP_AddConstraint( prob, (char*)consName.c_str(), 1, UFFLP_Less);
-                    }
-                    
-                }                
+    //Preenche os períodos
+    int faltam = 0;
+    for (int i = 0; i < n; i++){
+        periodo[i] = -1;
+        if (escolhida[i])
+            faltam++;
+    }
+    int ultimo = 0;
+    for (int j = 0; j < P && faltam > 0; j++){
+        vector<int> disponiveis;
+        for (int i = 0; i < n; i++){
+            if (!escolhida[i] || periodo[i] >= 0)
+                continue;
+            bool disponivel = true;
+            for (int c = data->preReqInicio[i]; c < data->preReqInicio[i + 1] && disponivel; c++){
+                if (clausulaAtendida(data, c))
+                    continue;
+                bool atendida = false;
+                for (int m = data->clausulaInicio[c]; m < data->clausulaInicio[c + 1]; m++){
+                    int k = data->clausulaMembro[m];
+                    if (periodo[k] >= 0 && periodo[k] < j)
+                        atendida = true;
+                }
+                disponivel = atendida;
             }
-            
+            if (disponivel)
+                disponiveis.push_back(i);
         }
-    }
-    
-    //SÉTIMA RESTRIÇÃO - PERÍODOS NECESSÁRIOS PARA TÉRMINO DO CURSO-N CONSIDERA CONJUNTO ME
-    for(int i = 0; i < data->disciplinas; i++){ // Entender contra barra e adicionar conjunto do estagio e monografia
-        if(!data->situacao[i]){
-            for(int j = 0; j < data->numPeriodos; j++){
-                s.clear();
-                s << "Periodos_Neces_" << i << "_" << j;
-                s >> consName;
-
-                s.clear();
-                s << "X(" << i << "," << j << ")";
-                s >> varName;
-                UFFLP_SetCoefficient( prob, (char*)consName.c_str(),(char*)varName.c_str(), j);
-
-                s.clear();
-                s << "Y";
-                s >> varName;
-                UFFLP_SetCoefficient( prob, (char*)consName.c_str(),(char*)varName.c_str(), -1);
-             
-                UFFLP_AddConstraint( prob, (char*)consName.c_str(), 0, UFFLP_Less);
+        //Urgência: períodos que ainda faltam depois deste, pela cadeia de dependentes ou pelas escolhidas
+        //ainda não alocadas que ocupam um mesmo slot (cada uma precisa de um período só para ela)
+        vector<int> ocupacao(SLOTS_HORARIO, 0);
+        for (int i = 0; i < n; i++)
+            if (escolhida[i] && periodo[i] < 0)
+                for (int t = 0; t < SLOTS_HORARIO; t++)
+                    if ((data->horarioBits[i].bits[t / 64] >> (t % 64)) & 1)
+                        ocupacao[t]++;
+        vector<int> urgencia(n, 0);
+        for (size_t a = 0; a < disponiveis.size(); a++){
+            int i = disponiveis[a];
+            urgencia[i] = altura[i];
+            for (int t = 0; t < SLOTS_HORARIO; t++)
+                if ((data->horarioBits[i].bits[t / 64] >> (t % 64)) & 1)
+                    urgencia[i] = max(urgencia[i], ocupacao[t] - 1);
+        }
+        for (size_t a = 1; a < disponiveis.size(); a++){
+            for (size_t b = a; b > 0; b--){
+                int x = disponiveis[b], y = disponiveis[b - 1];
+                if (urgencia[x] < urgencia[y] || (urgencia[x] == urgencia[y] && data->creditos[x] <= data->creditos[y]))
+                    break;
+                swap(disponiveis[b], disponiveis[b - 1]);
             }
         }
-    }
-
-    //OITAVA RESTRIÇÃO - FORÇA ESTAGIO E MONOGRAFIA PARA O ULTIMO PERÍODO
-    /*for (int i = 0; i < conj_estagio_monografia; i++){
-        s.clear();
-        s << "Estagio_Monografia_";
-        s >> consName;
-        for (int j = 0; j < data -> numPeriodos; j++){
-            s.clear();
-            s << "X(" << i << "," << j << ")";
-   	        s >> varName;
 
-            UFFLP_SetCoefficient( prob, (char*)consName.c_str(),(char*)varName.c_str(), data->numPeriodos);
+        int creditos = 0;
+        for (size_t a = 0; a < disponiveis.size(); a++){
+            int i = disponiveis[a];
+            if (creditos + data->creditos[i] > LIMITE_CREDITOS)
+                continue;
+            bool choca = false;
+            for (int v = data->choqueInicio[i]; v < data->choqueInicio[i + 1]; v++)
+                if (periodo[data->choqueVizinho[v]] == j)
+                    choca = true;
+            if (choca)
+                continue;
+            periodo[i] = j;
+            creditos += data->creditos[i];
+            ultimo = j;
+            faltam--;
         }
-        UFFLP_AddConstraint( prob, (char*)consName.c_str(), MIN_PERIODOS, UFFLP_Greater);
-    }*/
+    }
+    delete[] inicio;
 
-    //NONA RESTRIÇÃO
-    /*for (int i = 0; i < data->disciplinas; i++){
-        s.clear();
-        s << "Paga_Disciplina_";
-        s >> consName;
-        for (int j = 0; j < numPeriodos; j++){
-            s.clear();
-            s << "X(" << i << "," << j << ")";
-   	        s >> varName;
+    return (faltam > 0) ? -1 : max(1, ultimo);
+}
 
-            UFFLP_SetCoefficient( prob, (char*)consName.c_str(),(char*)varName.c_str(), 1);
+//Janela de períodos [inicio[i], fim[i]] em que X(i,j) pode valer 1, com Y limitado a ultimoY.
+//O início vem da cadeia de pré-requisitos. O fim desconta a cadeia de sucessoras obrigatórias:
+//uma disciplina que é pré-requisito único de outra que precisa ser cursada (obrigatória, ou ela
+//mesma pré-requisito único de uma) tem que vir antes dela. Concluídas ficam com janela vazia
+void calculaJanelas(Data* data, int ultimoY, int* inicio, int* fim){
+    int n = data->disciplinas;
+    calculaInicioMaisCedo(data, inicio);
+
+    //Pendentes em ordem decrescente de início: sucessoras antes dos seus pré-requisitos
+    vector<int> ordem;
+    for (int i = 0; i < n; i++)
+        if (!data->situacao[i])
+            ordem.push_back(i);
+    stable_sort(ordem.begin(), ordem.end(), [&](int a, int b){ return inicio[a] > inicio[b]; });
+
+    vector<bool> necessaria(n, false);
+    vector<int> cauda(n, 0);
+    for (int i = 0; i < n; i++)
+        necessaria[i] = !data->situacao[i] && data->identificadorOb[i] != 0;
+    for (int k : ordem){
+        if (!necessaria[k])
+            continue;
+        for (int c = data->preReqInicio[k]; c < data->preReqInicio[k + 1]; c++){
+            if (data->clausulaInicio[c + 1] - data->clausulaInicio[c] != 1 || clausulaAtendida(data, c))
+                continue;
+            int i = data->clausulaMembro[data->clausulaInicio[c]];
+            necessaria[i] = true;
+            cauda[i] = max(cauda[i], cauda[k] + 1);
         }
-        UFFLP_AddConstraint( prob, (char*)consName.c_str(), 1, UFFLP_Binary);
-    }*/
-
-/*--------------------------------------------------------------------------------------------------------------------------------------------
-    //DÉCIMA RESTRIÇÃO
-    s.clear();
-    s << "Y";
-   	s >> varName;
-    UFFLP_SetCoefficient( prob, (char*)consName.c_str(),(char*)varName.c_str(), 1);
-    UFFLP_AddConstraint( prob, (char*)consName.c_str(), MIN_PERIODOS, UFFLP_Greater); // Min_Periodos é o proprio y?
---------------------------------------------------------------------------------------------------------------------------------------------*/
-    // Escreve modelo no arquivo .lp
-    UFFLP_WriteLP( prob, "LP_SolveX.lp" );
-    UFFLP_SetLogInfo(prob, "mix.log" , 2);
-
-    UFFLP_StatusType status = UFFLP_Solve( prob, UFFLP_Minimize );
-
-    if (status == UFFLP_Optimal){
+    }
 
-        double value;
-        cout << "Solucao otima encontrada!" << endl << endl;
-        cout << "Solucao:" << endl;
+    for (int i = 0; i < n; i++){
+        if (data->situacao[i]){
+            inicio[i] = 0;
+            fim[i] = -1;
+        }else{
+            fim[i] = ultimoY - cauda[i];
+        }
+    }
+}
 
-        UFFLP_GetObjValue( prob, &value );
-        cout << "Valor da funcao objetivo = " << value << endl;
+//Linha do modelo montada por índice de variável e enviada de uma vez com UFFLP_AddRowIdx
+struct LinhaModelo{
+    vector<int> indices;
+    vector<double> coefs;
+};
+
+//Coloca "coef * variavel" na linha; variáveis que não existem no modelo (índice -1) e coeficientes nulos são ignorados
+static inline void adicionaCoef(LinhaModelo& linha, int var, double coef){
+    if (var < 0 || coef == 0)
+        return;
+    linha.indices.push_back(var);
+    linha.coefs.push_back(coef);
+}
 
+//Envia a linha ao modelo e a esvazia para reuso. Linhas sem coeficientes não são criadas
+static void adicionaLinha(UFFProblem* prob, LinhaModelo& linha, double rhs, UFFLP_ConsType tipo){
+    if (!linha.indices.empty())
+        UFFLP_AddRowIdx(prob, NULL, linha.indices.size(), &linha.indices[0], &linha.coefs[0], rhs, tipo, NULL);
+    linha.indices.clear();
+    linha.coefs.clear();
+}
 
-        // Imprime valor das variaveis nao-nulas
-        //Cria objeto de JSON para registrar a saída de dados p/ o front-end da aplicação
-        json jSaida;
-        //Baseado no valor da função objetivo(numero de periodos que alcançou), cria o json com a quantidade certas de períodos
-        //for (int i = 0; i <= value; i++){
-          //  jSaida.push_back(to_string(i));
-        //}
-        ofstream jOutput("jSaidaX.json");
+//Linha "X(i,j) + X(k,j) <= 1" para cada período j em que as duas variáveis existem
+static void restricaoChoquePar(UFFProblem* prob, Data* data, const int* varX, int i, int k){
+    LinhaModelo linha;
+    for(int j = 0; j < data->numPeriodos; j++){
+        if (varX[k * data->numPeriodos + j] < 0 || varX[i * data->numPeriodos + j] < 0)
+            continue;
+        adicionaCoef(linha, varX[k * data->numPeriodos + j], 1);
+        adicionaCoef(linha, varX[i * data->numPeriodos + j], 1);
+        adicionaLinha(prob, linha, 1, UFFLP_Less);
+    }
+}
 
-            for (int i = 0; i < data->disciplinas; i++) {
-                //cout << " aqui " << data->situacao[i] << i << value << endl;
-                if (!data->situacao[i]){
-                    for (int j = 0; j < data->numPeriodos; j++) {
+//Restrições de choque de horário entre disciplinas pendentes, de acordo com data->formulacaoChoque.
+//Em CHOQUE_SLOT, as disciplinas que ocupam um mesmo slot formam uma clique: uma linha
+//"soma X(i,j) <= 1" por (slot, período) substitui todos os pares dela. Cliques repetidas ou contidas
+//em outra (ex.: os 4 slots de "35M23") geram uma linha só.
+static void restricoesChoque(UFFProblem* prob, Data* data, const int* varX){
+    if (data->formulacaoChoque == CHOQUE_PARES){
+        for(int i = 0; i < data->disciplinas; i++){
+            if(data->situacao[i])
+                continue;
+            for(int v = data->choqueInicio[i]; v < data->choqueInicio[i+1]; v++){
+                int k = data->choqueVizinho[v];
+                if (k > i && !data->situacao[k])
+                    restricaoChoquePar(prob, data, varX, i, k);
+            }
+        }
+        return;
+    }
 
-                    s.clear();
-                    s << "X(" << i << "," << j << ")";
-                    s >> varName;
-                    UFFLP_GetSolution( prob, (char*)varName.c_str(), &value );
+    //Disciplinas pendentes em cada slot
+    vector< vector<int> > cliques;
+    for (int slot = 0; slot < SLOTS_HORARIO; slot++){
+        vector<int> clique;
+        for (int i = 0; i < data->disciplinas; i++)
+            if (!data->situacao[i] && ((data->horarioBits[i].bits[slot >> 6] >> (slot & 63)) & 1))
+                clique.push_back(i);
+        if (clique.size() >= 2)
+            cliques.push_back(clique);
+    }
 
-                    if (value > 0.1) {
-                        cout << setw(4) << "Cadeira: " << setw(4) << data->nomeCadeira[i] << setw(60-(data->nomeCadeira[i].size())) << ", Periodo[" << j << "] Horario: " << data->horario[i] << endl;
-                        //cout << varName << " = " << value << endl;
-                        //O JSON DE SAÍDA SERÁ GERADO AQUI
-                        jSaida["Semestre_" + to_string(j)].push_back(data->nomeCadeira[i]); //Para cada cadeira
-                    }
-                }
+    //Descarta cliques contidas em outra maior (ou iguais a uma já mantida)
+    vector<int> ordem(cliques.size());
+    for (int c = 0; c < (int)ordem.size(); c++)
+        ordem[c] = c;
+    stable_sort(ordem.begin(), ordem.end(), [&](int a, int b){ return cliques[a].size() > cliques[b].size(); });
+
+    vector<int> mantidas;
+    for (int c : ordem){
+        bool dominada = false;
+        for (int m : mantidas){
+            if (includes(cliques[m].begin(), cliques[m].end(), cliques[c].begin(), cliques[c].end())){
+                dominada = true;
+                break;
             }
         }
-        jOutput << setw(4) <<  jSaida << endl;
-        jOutput.close();
-        cout << endl;
-    }else{
-        cout << "Não foi encontrada uma solução ótima, tente novamente mais tarde!" << endl;
+        if (!dominada)
+            mantidas.push_back(c);
     }
 
+    LinhaModelo linha;
+    for (int j = 0; j < data->numPeriodos; j++){
+        for (int c : mantidas){
+            for (int i : cliques[c])
+                adicionaCoef(linha, varX[i * data->numPeriodos + j], 1);
+            if (linha.indices.size() < 2){ //Uma variável só não choca com ninguém
+                linha.indices.clear();
+                linha.coefs.clear();
+            }
+            adicionaLinha(prob, linha, 1, UFFLP_Less);
+        }
+    }
 
-    // Destroy the problem instance
-    UFFLP_DestroyProblem( prob );
+    //Horários não reconhecidos não ocupam slots, continuam por pares
+    for (int i = 0; i < data->disciplinas; i++){
+        if (data->situacao[i] || !mascaraVazia(data->horarioBits[i]))
+            continue;
+        for (int v = data->choqueInicio[i]; v < data->choqueInicio[i+1]; v++){
+            int k = data->choqueVizinho[v];
+            if (k > i && !data->situacao[k])
+                restricaoChoquePar(prob, data, varX, i, k);
+        }
+    }
 }
 
-double solveCoin_Y(Data* data){
-    // Cria problema
-    UFFProblem* prob = UFFLP_CreateProblem();
-
-    // Cria variaveis X
-	string varName, consName;
-  	stringstream s;
+//Liga as disciplinas pendentes ao número de períodos Y, de acordo com data->formulacaoPeriodos.
+//Como cada disciplina é paga no máximo uma vez, a forma agregada "soma_j j*X(i,j) <= Y" equivale
+//às numPeriodos linhas "j*X(i,j) <= Y" da forma desagregada, com uma linha por disciplina.
+static void restricoesPeriodos(UFFProblem* prob, Data* data, const int* varX, int varY){
+    LinhaModelo linha;
 
-    // Definindo FUNC Obj. Y
-    s.clear();
-    s << "Y";
-    s >> varName;
-    UFFLP_AddVariable(prob, (char*)varName.c_str(), 1.0, 10.0, 1, UFFLP_Integer);
+    for(int i = 0; i < data->disciplinas; i++){
+        if(data->situacao[i])
+            continue;
 
-    // Definindo FUNC Obj. Xij
-    for (int i = 0; i < data->disciplinas; i++) {
+        if (data->formulacaoPeriodos == PERIODOS_AGREGADO){
+            for(int j = 1; j < data->numPeriodos; j++)
+                adicionaCoef(linha, varX[i * data->numPeriodos + j], j);
+            adicionaCoef(linha, varY, -1);
+            adicionaLinha(prob, linha, 0, UFFLP_Less);
+            continue;
+        }
 
-		for (int j = 0; j < data->numPeriodos; j++) {
-            if (!data->situacao[i]){
-                s.clear();
-                s << "X(" << i << "," << j << ")";
-                s >> varName;
-                UFFLP_AddVariable(prob, (char*)varName.c_str(), 0.0, 1.0, 0, UFFLP_Binary);
-            }
-                
-		}
-	}
+        for(int j = 0; j < data->numPeriodos; j++){
+            if (varX[i * data->numPeriodos + j] < 0)
+                continue;
+            adicionaCoef(linha, varX[i * data->numPeriodos + j], j);
+            adicionaCoef(linha, varY, -1);
+            adicionaLinha(prob, linha, 0, UFFLP_Less);
+        }
+    }
+}
 
+//Restrições comuns aos dois modelos (primeira à sexta). varX[i * numPeriodos + j] é o índice de X(i,j)
+//no modelo, ou -1 se a variável não foi criada
+static void restricoesBase(UFFProblem* prob, Data* data, const int* varX){
+    int P = data->numPeriodos;
+    LinhaModelo linha;
 
     //PRIMEIRA RESTRIÇÃO DO MODELO - LIMITE DE CRÉDITOS POR PERÍODO
-    for (int j = 0; j < data->numPeriodos; j++){
-        s.clear();
-        s << "LimCreditos_" << j;
-        s >> consName;
-
+    for (int j = 0; j < P; j++){
         for (int i = 0; i < data->disciplinas; i++){
-            if (!data->situacao[i]){
-                s.clear();
-                s << "X(" << i << "," << j << ")";
-                s >> varName;
-                UFFLP_SetCoefficient( prob, (char*)consName.c_str(),(char*)varName.c_str(), data->creditos[i]);   
-            }        
+            if (!data->situacao[i])
+                adicionaCoef(linha, varX[i * P + j], data->creditos[i]);
         }
-        UFFLP_AddConstraint( prob, (char*)consName.c_str(), LIMITE_CREDITOS, UFFLP_Less);
+        adicionaLinha(prob, linha, LIMITE_CREDITOS, UFFLP_Less);
     }
 
     //SEGUNDA RESTRIÇÃO
     for (int i = 0; i < data->disciplinas; i++){ // Usando número de disciplinas faltantes pois é a mesma quantidade de disciplinas obrigatórias
         if(!data->situacao[i] && data->identificadorOb[i] != 0){
-            s.clear();
-            s << "Obrigatorias_" << i;
-            s >> consName;
-                for(int j = 0; j < data->numPeriodos; j++){
-                    s.clear();
-                    s << "X(" << i << "," << j << ")";
-                    s >> varName;
-                    UFFLP_SetCoefficient( prob, (char*)consName.c_str(),(char*)varName.c_str(), 1);
-                }
-            UFFLP_AddConstraint( prob, (char*)consName.c_str(), 1, UFFLP_Equal);
+            for(int j = 0; j < P; j++)
+                adicionaCoef(linha, varX[i * P + j], 1);
+            adicionaLinha(prob, linha, 1, UFFLP_Equal);
         }
     }
 
     //TERCEIRA RESTRIÇÃO DO MODELO - obriga mínimo de créditos de optativas
-    s.clear();
-    s << "MinCreditoOptativas_";
-    s >> consName;
     for (int i = 0; i < data->disciplinas; i++){
         if(!data->situacao[i] && data->identificadorOp[i] != 0){
-            for (int j = 0; j < data->numPeriodos; j++){
-                s.clear();
-                s << "X(" << i << "," << j << ")";
-                s >> varName;
-                UFFLP_SetCoefficient( prob, (char*)consName.c_str(),(char*)varName.c_str(), data->creditos[i]);
-            }
+            for (int j = 0; j < P; j++)
+                adicionaCoef(linha, varX[i * P + j], data->creditos[i]);
         }
     }
-    UFFLP_AddConstraint(prob, (char*)consName.c_str(), data->numCreditosOp, UFFLP_Greater);
-    
+    adicionaLinha(prob, linha, data->numCreditosOp, UFFLP_Greater);
 
     //QUARTA RESTRIÇÃO- PAGA OP APENAS UMA VEZ POR PERÍODO
     for (int i = 0; i < data->disciplinas; i++){ // Usando número de disciplinas faltantes pois é a mesma quantidade de disciplinas obrigatórias
         if (!data->situacao[i] && data->identificadorOp[i] != 0){
-            s.clear();
-            s << "OpUmaVez_" << i;
-            s >> consName;
-            for(int j = 0; j < data->numPeriodos; j++){
-                s.clear();
-                s << "X(" << i << "," << j << ")";
-                s >> varName;
-                UFFLP_SetCoefficient( prob, (char*)consName.c_str(),(char*)varName.c_str(), 1);
-            }
+            for(int j = 0; j < P; j++)
+                adicionaCoef(linha, varX[i * P + j], 1);
+            adicionaLinha(prob, linha, 1, UFFLP_Less);
         }
-        UFFLP_AddConstraint(prob, (char*)consName.c_str(), 1, UFFLP_Less);
     }
 
     //QUINTA RESTRIÇÃO - PRE-REQUISITOS
+    //Para cada cláusula de i: X(i,j) <= soma de X(k,t) com k na cláusula e t < j. Cláusulas com
+    //alguma disciplina já concluída estão atendidas e não geram linha
     for (int i = 0; i < data->disciplinas; i++){
         if(!data->situacao[i]){
-            for (int k = 0; k < data->disciplinas; k++){
-                if (data->preReqI[i][k] != 0){
-                    s.clear();
-                    s << "PreReq_" << i << "_" << k;
-                    s >> consName;
-
-                    for(int j = 0; j < data->numPeriodos; j++){
-                        s.clear();
-                        s << "X(" << i << "," << j << ")";
-                        s >> varName;
-                        UFFLP_SetCoefficient( prob, (char*)consName.c_str(),(char*)varName.c_str(), j);
-            
-                        s.clear();
-                        s << "X(" << k << "," << j << ")";
-                        s >> varName;
-                        UFFLP_SetCoefficient( prob, (char*)consName.c_str(),(char*)varName.c_str(), -j);
-                    }
-                    UFFLP_AddConstraint( prob, (char*)consName.c_str(), 1, UFFLP_Greater);
+            for (int c = data->preReqInicio[i]; c < data->preReqInicio[i + 1]; c++){
+                bool atendida = false;
+                for (int m = data->clausulaInicio[c]; m < data->clausulaInicio[c + 1]; m++)
+                    if (data->situacao[data->clausulaMembro[m]])
+                        atendida = true;
+                if (atendida)
+                    continue;
+
+                for(int j = 0; j < P; j++){
+                    if (varX[i * P + j] < 0)
+                        continue;
+                    adicionaCoef(linha, varX[i * P + j], 1);
+                    for (int m = data->clausulaInicio[c]; m < data->clausulaInicio[c + 1]; m++)
+                        for (int t = 0; t < j; t++)
+                            adicionaCoef(linha, varX[data->clausulaMembro[m] * P + t], -1);
+                    adicionaLinha(prob, linha, 0, UFFLP_Less);
                 }
             }
         }
     }
 
-    
-    //SEXTA RESTRIÇÃO
-    for(int j = 0; j < data->numPeriodos; j++){
-        for(int i = 0; i < data->disciplinas; i++){
-            if(!data->situacao[i]){
-                for(int k = 0; k < data->disciplinas; k++){
-                    if ((data->choqueHorarioI[i][k] == true) && (i != k)){
-                        s.clear();
-                        s << "Choq_Horario_" << j << "_" << i << "_" << k;
-                        s >> consName;
-
-                        s.clear();
-                        s << "X(" << k << "," << j << ")";
-                        s >> varName;
-                        UFFLP_SetCoefficient( prob, (char*)consName.c_str(),(char*)varName.c_str(), 1);
-
-                        s.clear();
-                        s << "X(" << i << "," << j << ")";
-                        s >> varName;
-                        UFFLP_SetCoefficient( prob, (char*)consName.c_str(),(char*)varName.c_str(), 1);
-                        UFFLP_AddConstraint( prob, (char*)consName.c_str(), 1, UFFLP_Less);
-                    }
-                    
-                }                
-            }
-            
-        }
+    //SEXTA RESTRIÇÃO - CHOQUE DE HORÁRIO
+    restricoesChoque(prob, data, varX);
+}
+
+//SAÍDA
+
+//Imprime a grade (período de cada disciplina, -1 se fora dela) e grava no arquivo JSON lido pelo
+//front-end da aplicação, com as cadeiras de cada semestre: {"Semestre_j": [...]}
+void escreveGrade(Data* data, const int* periodo, const char* arquivo){
+    CronometroFase fase(data->metricas, "escreveGrade");
+    json jSaida;
+    for (int i = 0; i < data->disciplinas; i++) {
+        int j = periodo[i];
+        if (j < 0)
+            continue;
+        cout << setw(4) << "Cadeira: " << setw(4) << data->nomeCadeira[i] << setw(60-(data->nomeCadeira[i].size())) << ", Periodo[" << j << "] Horario: " << data->horario[i] << endl;
+        jSaida["Semestre_" + to_string(j)].push_back(data->nomeCadeira[i]); //Para cada cadeira
     }
-      
-    //SÉTIMA RESTRIÇÃO - PERÍODOS NECESSÁRIOS PARA TÉRMINO DO CURSO-N CONSIDERA CONJUNTO ME
-    for(int i = 0; i < data->disciplinas; i++){ // -3 para não adicionar estagio, tcc1 e tcc2
-        if(!data->situacao[i]){
-            for(int j = 0; j < data->numPeriodos; j++){
-                s.clear();
-                s << "Periodos_Neces_" << i << "_" << j;
-                s >> consName;
+    if (data->saidaMemoria != NULL){
+        (*data->saidaMemoria)[arquivo] = jSaida;
+        return;
+    }
+    ofstream jOutput((data->prefixoSaida + arquivo).c_str());
+    jOutput << setw(4) <<  jSaida << endl;
+    jOutput.close();
+}
 
-                s.clear();
-                s << "X(" << i << "," << j << ")";
-                s >> varName;
-                UFFLP_SetCoefficient( prob, (char*)consName.c_str(),(char*)varName.c_str(), j);
+//HEURÍSTICA PRIMAL
+
+//Escreve em solucao (por coluna do modelo) a grade dada por periodo, com Y no menor valor permitido.
+//Retorna falso se a grade não cabe nos limites atuais de Y ou se alguma disciplina cai fora da sua janela
+static bool gradeParaColunas(Data* data, Modelo* modelo, const int* periodo, int ultimo, double* solucao){
+    int P = modelo->numPeriodos;
+    int valorY = max(ultimo, modelo->minY);
+    if (ultimo < 0 || valorY > modelo->maxY)
+        return false;
+    for (int c = 0; c < modelo->numColunas; c++)
+        solucao[c] = 0;
+    solucao[modelo->varY] = valorY;
+    for (int i = 0; i < data->disciplinas; i++){
+        if (periodo[i] < 0)
+            continue;
+        if (modelo->varX[i * P + periodo[i]] < 0)
+            return false;
+        solucao[modelo->varX[i * P + periodo[i]]] = 1;
+    }
+    return true;
+}
 
-                s.clear();
-                s << "Y";
-                s >> varName;
-                UFFLP_SetCoefficient( prob, (char*)consName.c_str(),(char*)varName.c_str(), -1);
-             
-                UFFLP_AddConstraint( prob, (char*)consName.c_str(), 0, UFFLP_Less);
-            }
-        }
+//Callback de heurística primal: refaz a grade gulosa escolhendo primeiro as optativas e alternativas
+//com mais peso na relaxação linear do nó e entrega ao Cbc como solução inteira
+static void STDCALL heuristicaGulosa(UFFProblem* prob){
+    void* contexto = NULL;
+    UFFLP_GetCallBackData(prob, &contexto);
+    Modelo* modelo = (Modelo*)contexto;
+    if (modelo == NULL || modelo->data == NULL)
+        return;
+    Data* data = modelo->data;
+
+    double *relaxacao = new double[modelo->numColunas];
+    if (UFFLP_GetSolutionVector(prob, relaxacao, modelo->numColunas) != UFFLP_Ok){
+        delete[] relaxacao;
+        return;
     }
+    double *preferencia = new double[data->disciplinas];
+    for (int i = 0; i < data->disciplinas; i++)
+        preferencia[i] = 0;
+    for (int c = 0; c < modelo->numColunas; c++)
+        if (modelo->disciplinaColuna[c] >= 0)
+            preferencia[modelo->disciplinaColuna[c]] += relaxacao[c];
+
+    int *periodo = new int[data->disciplinas];
+    int ultimo = escalonamentoGuloso(data, periodo, preferencia);
+    if (gradeParaColunas(data, modelo, periodo, ultimo, relaxacao)){
+        for (int c = 0; c < modelo->numColunas; c++)
+            if (relaxacao[c] != 0)
+                UFFLP_SetSolutionIdx(prob, c, relaxacao[c]);
+    }
+    delete[] relaxacao;
+    delete[] preferencia;
+    delete[] periodo;
+}
+
+//Modo só heurística (--heuristic-only): grava a grade gulosa em jSaidaX.json sem montar o modelo
+void solveHeuristica(Data* data){
+    int *periodo = new int[data->disciplinas];
+    int ultimo = escalonamentoGuloso(data, periodo);
+    if (ultimo < 0){
+        cout << "A grade gulosa nao coube em " << data->numPeriodos << " periodos" << endl;
+        delete[] periodo;
+        return;
+    }
+    cout << "Grade gulosa com Y = " << ultimo << endl << endl;
+    escreveGrade(data, periodo, "jSaidaX.json");
+    delete[] periodo;
+    cout << endl;
+}
+
+//Monta uma única vez o modelo usado nas duas etapas: as variáveis e as sete famílias de restrições são
+//as mesmas, só mudam a função objetivo e os limites de Y, trocados depois em solveCoin.
+//A grade gulosa, calculada antes, limita Y por cima; X(i,j) só é criada dentro da janela de i
+void constroiModelo(Data* data, Modelo* modelo){
+    // Cria problema
+    UFFProblem* prob = UFFLP_CreateProblem();
+    int P = data->numPeriodos;
+
+    //PRÉ-PROCESSAMENTO: grade gulosa e janelas de períodos
+    int *periodoGuloso = new int[data->disciplinas];
+    int gulosoY = escalonamentoGuloso(data, periodoGuloso);
+    int maxY = min(10, P - 1);
+    if (gulosoY >= 1 && gulosoY < maxY)
+        maxY = gulosoY;
+
+    int *inicio = new int[data->disciplinas];
+    int *fim = new int[data->disciplinas];
+    calculaJanelas(data, maxY, inicio, fim);
+
+    // Definindo FUNC Obj. Y
+    int varY;
+    UFFLP_AddVariableIdx(prob, (char*)"Y", 1.0, maxY, 1, UFFLP_Integer, &varY);
+
+    // Definindo FUNC Obj. Xij (apenas disciplinas pendentes, dentro da janela)
+    int *varX = new int[data->disciplinas * P];
+    vector<int> disciplinaColuna(1, -1), periodoColuna(1, -1); //Coluna 0 é Y
+    char varName[32];
+    for (int i = 0; i < data->disciplinas; i++) {
+        //Obrigatória sem janela: a instância é inviável, mantém todos os períodos para o solver provar
+        if (!data->situacao[i] && data->identificadorOb[i] != 0 && inicio[i] > fim[i]){
+            inicio[i] = 0;
+            fim[i] = P - 1;
+        }
+		for (int j = 0; j < P; j++) {
+            varX[i * P + j] = -1;
+            if (!data->situacao[i] && j >= inicio[i] && j <= fim[i]){
+                snprintf(varName, sizeof(varName), "X(%d,%d)", i, j);
+                UFFLP_AddVariableIdx(prob, varName, 0.0, 1.0, 0, UFFLP_Binary, &varX[i * P + j]);
+                disciplinaColuna.push_back(i);
+                periodoColuna.push_back(j);
+            }
+		}
+	}
+    cout << "Variaveis X criadas: " << disciplinaColuna.size() - 1 << ", Y <= " << maxY << endl;
+    delete[] inicio;
+    delete[] fim;
+
+    //PRIMEIRA A SEXTA RESTRIÇÃO
+    restricoesBase(prob, data, varX);
+      
+    //SÉTIMA RESTRIÇÃO - PERÍODOS NECESSÁRIOS PARA TÉRMINO DO CURSO-N CONSIDERA CONJUNTO ME
+    restricoesPeriodos(prob, data, varX, varY);
     /*
     //OITAVA RESTRIÇÃO - FORÇA ESTAGIO E MONOGRAFIA PARA O ULTIMO PERÍODO
     for (int i = data->disciplinas-3; i < data->disciplinas; i++){
@@ -824,21 +1192,82 @@ double solveCoin_Y(Data* data){
 
 
     //DÉCIMA RESTRIÇÃO
-    s.clear();
-    s << "Y";
-   	s >> consName;
-    s.clear();
-    s << "Y";
-    s >> varName;
-
-    UFFLP_SetCoefficient( prob, (char*)consName.c_str(),(char*)varName.c_str(), 1);
-    UFFLP_AddConstraint( prob, (char*)consName.c_str(), 0, UFFLP_Greater);
-    
+    LinhaModelo linha;
+    adicionaCoef(linha, varY, 1);
+    adicionaLinha(prob, linha, 0, UFFLP_Greater);
+
+    modelo->prob = prob;
+    modelo->varX = varX;
+    modelo->varY = varY;
+    modelo->numPeriodos = P;
+    modelo->minY = 1;
+    modelo->maxY = maxY;
+    modelo->valorY = -1;
+    modelo->gulosoY = gulosoY;
+    modelo->periodoGuloso = periodoGuloso;
+    modelo->numColunas = disciplinaColuna.size();
+    modelo->disciplinaColuna = new int[modelo->numColunas];
+    modelo->periodoColuna = new int[modelo->numColunas];
+    for (int c = 0; c < modelo->numColunas; c++){
+        modelo->disciplinaColuna[c] = disciplinaColuna[c];
+        modelo->periodoColuna[c] = periodoColuna[c];
+    }
+    modelo->solucaoY = new double[modelo->numColunas];
+
+    //Heurística primal guiada pela relaxação; o modelo (com o aluno) vai para o callback pela UFFLP
+    modelo->data = data;
+    UFFLP_SetCallBackData(prob, modelo);
+    UFFLP_SetHeurCallBack(prob, heuristicaGulosa);
+}
+
+void destroiModelo(Modelo* modelo){
+    // Destroy the problem instance
+    UFFLP_DestroyProblem( modelo->prob );
+    delete[] modelo->varX;
+    delete[] modelo->solucaoY;
+    delete[] modelo->periodoGuloso;
+    delete[] modelo->disciplinaColuna;
+    delete[] modelo->periodoColuna;
+    modelo->prob = NULL;
+    modelo->varX = NULL;
+    modelo->solucaoY = NULL;
+    modelo->periodoGuloso = NULL;
+    modelo->disciplinaColuna = NULL;
+    modelo->periodoColuna = NULL;
+    modelo->data = NULL;
+}
+
+//Segunda etapa: com Y fixo no valor ótimo da primeira, minimiza a soma dos períodos das disciplinas.
+//Reaproveita o modelo da primeira etapa trocando só os limites de Y e a função objetivo
+void solveCoin(Data* data, Modelo* modelo){
+    cout << "NUMERO DE PERIDOSODASOJDASO CERTO?" << data->numPeriodos << endl;
+    UFFProblem* prob = modelo->prob;
+
+    if (modelo->valorY >= 1){
+        UFFLP_ChangeBoundsIdx(prob, modelo->varY, modelo->valorY, modelo->valorY);
+        modelo->minY = modelo->maxY = modelo->valorY;
+    }
+
+    //Troca a função objetivo: Y sai, X(i,j) entra com custo j
+    UFFLP_ChangeObjCoeffIdx(prob, modelo->varY, 0);
+    for (int c = 0; c < modelo->numColunas; c++)
+        if (modelo->disciplinaColuna[c] >= 0)
+            UFFLP_ChangeObjCoeffIdx(prob, c, modelo->periodoColuna[c]);
+
+    //A grade da primeira etapa continua viável com Y fixo: entra como solução inicial e corte da busca
+    if (modelo->valorY >= 1)
+        UFFLP_SetInitialSolution(prob, modelo->numColunas, modelo->solucaoY);
+
     // Escreve modelo no arquivo .lp
-    UFFLP_WriteLP( prob, "LP_SolveY.lp" );
+    if (data->saidaMemoria == NULL){
+        CronometroFase fase(data->metricas, "escreveLP");
+        UFFLP_WriteLP( prob, (char*)(data->prefixoSaida + "LP_SolveX.lp").c_str() );
+        UFFLP_SetLogInfo(prob, (char*)(data->prefixoSaida + "mix.log").c_str() , 2);
+    }
 
     UFFLP_StatusType status = UFFLP_Solve( prob, UFFLP_Minimize );
-    
+    registraSolve(data->metricas, "solveX", prob);
+
     if (status == UFFLP_Optimal){
 
         double value;
@@ -846,52 +1275,100 @@ double solveCoin_Y(Data* data){
         cout << "Solucao:" << endl;
 
         UFFLP_GetObjValue( prob, &value );
-        cout << setw(4) << "Valor da funcao objetivo = " << value << endl;
-        data->numPeriodos = value+1;
-        //Cria objeto de JSON para registrar a saída de dados p/ o front-end da aplicação
-        json jSaida;
-        //Baseado no valor da função objetivo(numero de periodos que alcançou), cria o json com a quantidade certas de períodos
-        //for (int i = 0; i <= value; i++){
-          //  jSaida.push_back(to_string(i));
-        //}
-        ofstream jOutput("jSaidaY.json");
-        //jOutput << setw(4) <<  jSaida << endl;
-	    cout << jSaida << endl;
-        // Imprime valor das variaveis nao-nulas
-        for (int i = 0; i < data->disciplinas; i++) {
-            if(!data->situacao[i]){
-                for (int j = 0; j < data->numPeriodos; j++) {
-                    s.clear();
-                    s << "X(" << i << "," << j << ")";
-                    s >> varName;
-                    UFFLP_GetSolution( prob, (char*)varName.c_str(), &value );
+        cout << "Valor da funcao objetivo = " << value << endl;
 
-                    if (value > 0.1) {
-                        //cout << varName << " = " << value << endl;
-                        cout << setw(4) << "Cadeira: " << setw(4) << data->nomeCadeira[i] << setw(60-(data->nomeCadeira[i].size())) << ", Periodo[" << j << "] Horario: " << data->horario[i] << endl; 
 
-                        //------------------------------------------------------------------------------------------
-                        //O JSON DE SAÍDA SERÁ GERADO AQUI
-                        jSaida["Semestre_" + to_string(j)].push_back(data->nomeCadeira[i]); //Para cada cadeira
-                    }  
-                }           
-            }
+        // Lê só as variáveis não-nulas e monta a grade
+        int *colunas = new int[modelo->numColunas];
+        double *valores = new double[modelo->numColunas];
+        int *periodo = new int[data->disciplinas];
+        int nz = 0;
+        UFFLP_GetSolutionNonzeros( prob, 0.1, colunas, valores, modelo->numColunas, &nz );
+        for (int i = 0; i < data->disciplinas; i++)
+            periodo[i] = -1;
+        for (int k = 0; k < nz; k++)
+            if (modelo->disciplinaColuna[colunas[k]] >= 0)
+                periodo[modelo->disciplinaColuna[colunas[k]]] = modelo->periodoColuna[colunas[k]];
+
+        escreveGrade(data, periodo, "jSaidaX.json");
+        delete[] colunas;
+        delete[] valores;
+        delete[] periodo;
+        cout << endl;
+    }else{
+        cout << "Não foi encontrada uma solução ótima, tente novamente mais tarde!" << endl;
+    }
+}
+
+//Primeira etapa: minimiza o número de períodos Y
+double solveCoin_Y(Data* data, Modelo* modelo){
+    UFFProblem* prob = modelo->prob;
+    
+    // Escreve modelo no arquivo .lp
+    if (data->saidaMemoria == NULL){
+        CronometroFase fase(data->metricas, "escreveLP");
+        UFFLP_WriteLP( prob, (char*)(data->prefixoSaida + "LP_SolveY.lp").c_str() );
+    }
+
+    //PRÉ-PROCESSAMENTO: limite inferior de Y e grade gulosa
+    int limiteY = limiteInferiorY(data);
+    int gulosoY = modelo->gulosoY;
+    int *periodo = modelo->periodoGuloso;
+    cout << "Limite inferior de Y = " << limiteY << ", Y da grade gulosa = " << gulosoY << endl;
+    registraContador(data->metricas, "solveY.limiteInferior", limiteY);
+    registraContador(data->metricas, "solveY.gulosoY", gulosoY);
+
+    //Grade gulosa como vetor de solução do modelo (calculada em constroiModelo, dentro das janelas)
+    bool temGuloso = gradeParaColunas(data, modelo, periodo, gulosoY, modelo->solucaoY);
+
+    UFFLP_StatusType status;
+    double value = 0;
+    if (temGuloso && gulosoY <= limiteY){
+        //A grade gulosa atinge o limite inferior, então já é ótima e o MIP não é resolvido
+        cout << "Grade gulosa atinge o limite inferior, MIP da primeira etapa dispensado" << endl;
+        registraContador(data->metricas, "solveY.mipDispensado", 1);
+        status = UFFLP_Optimal;
+        value = gulosoY;
+    }else{
+        UFFLP_ChangeBoundsIdx( prob, modelo->varY, limiteY, modelo->maxY );
+        modelo->minY = limiteY;
+        if (temGuloso)
+            UFFLP_SetInitialSolution( prob, modelo->numColunas, modelo->solucaoY );
+
+        status = UFFLP_Solve( prob, UFFLP_Minimize );
+        registraSolve(data->metricas, "solveY", prob);
+        if (status == UFFLP_Optimal){
+            UFFLP_GetObjValue( prob, &value );
+            UFFLP_GetSolutionVector( prob, modelo->solucaoY, modelo->numColunas );
+            for (int c = 0; c < modelo->numColunas; c++)
+                modelo->solucaoY[c] = (int)(modelo->solucaoY[c] + 0.5); //Todas as variáveis são inteiras
         }
+    }
 
-        // for (int i = 7; i < data->numPeriodos; i++){
-        //     jSaida["Semestre_" + to_string(i)] = json::array();
-        // }
+    if (status == UFFLP_Optimal){
+
+        cout << "Solucao otima encontrada!" << endl << endl;
+        cout << "Solucao:" << endl;
+
+        cout << setw(4) << "Valor da funcao objetivo = " << value << endl;
+        data->numPeriodos = value+1;
+        modelo->valorY = value;
+        // Monta a grade com as variáveis não-nulas da solução
+        int *grade = new int[data->disciplinas];
+        for (int i = 0; i < data->disciplinas; i++)
+            grade[i] = -1;
+        for (int c = 0; c < modelo->numColunas; c++)
+            if (modelo->disciplinaColuna[c] >= 0 && modelo->solucaoY[c] > 0.1)
+                grade[modelo->disciplinaColuna[c]] = modelo->periodoColuna[c];
+
+        escreveGrade(data, grade, "jSaidaY.json");
+        delete[] grade;
 
-        jOutput << setw(4) <<  jSaida << endl;
-	    cout << jSaida;
-        jOutput.close();
-        
         cout << "NUMERO DE PERIDOSODASOJDASO CERTO?" << data->numPeriodos << endl;
         cout << endl;
     }else{
         cout << "Não foi encontrada uma solução ótima, tente novamente mais tarde!" << endl;
     }
 
-    // Destroy the problem instance
-    UFFLP_DestroyProblem( prob );
-}
\ No newline at end of file
+    return value;
+}
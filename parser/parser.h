@@ -7,14 +7,94 @@
 #include <fstream>
 #include <string>
 #include <sstream>
+#include <unordered_map>
+#include <stdint.h>
+#include <cctype>
+#include <algorithm>
+#include <cmath>
+#include <chrono>
 #include "UFFLP/UFFLP.h"
 
 #define MAX_DISCIPLINAS 92
 #define LIMITE_CREDITOS 32
 
+//Programação dinâmica exata para alunos com poucas pendentes (programacaoDinamica.cpp)
+#define LIMITE_PD 25              // Máximo de disciplinas pendentes para usar a programação dinâmica
+#define LIMITE_ESTADOS_PD 2000000 // Estados calculados antes de desistir e usar o MIP
+
+//Dimensões da grade do SIGAA: dias 2 (segunda) a 7 (sábado), turnos M/T/N e até 6 aulas por turno
+#define DIAS_SEMANA 6
+#define TURNOS 3
+#define AULAS_TURNO 6
+#define SLOTS_HORARIO (DIAS_SEMANA * TURNOS * AULAS_TURNO) // 108 slots, cabe em 128 bits
+
+//Formulações da restrição de choque de horário
+#define CHOQUE_PARES 0 // Uma linha por par de disciplinas pendentes que chocam, em cada período
+#define CHOQUE_SLOT 1  // Uma linha de empacotamento por slot ocupado, em cada período
+
+//Formulações da ligação entre X(i,j) e o número de períodos Y
+#define PERIODOS_DESAGREGADO 0 // j*X(i,j) - Y <= 0 para cada disciplina pendente e período
+#define PERIODOS_AGREGADO 1    // soma_j j*X(i,j) - Y <= 0 para cada disciplina pendente
+
 using namespace std;
 using json = nlohmann::json; //Para utiliar as funções da biblioteca do JSON
 
+//Horário de uma disciplina como conjunto de slots (dia x turno x aula) ocupados
+struct MascaraHorario{
+    uint64_t bits[2];
+};
+
+//Duas disciplinas chocam se ocupam algum slot em comum
+inline bool choqueMascara(const MascaraHorario& a, const MascaraHorario& b){
+    return ((a.bits[0] & b.bits[0]) | (a.bits[1] & b.bits[1])) != 0;
+}
+
+inline bool mascaraVazia(const MascaraHorario& a){
+    return (a.bits[0] | a.bits[1]) == 0;
+}
+
+//Dados do curso, iguais para todos os alunos: montado uma vez (leCurriculo) e depois só lido, então
+//pode ser compartilhado pelos alunos de um lote
+struct Curriculo{
+    int *identificador;
+    string *nomeCadeira;
+    int *creditos;
+    int *preReqInicio;   //Pré-requisitos em CSR, como em Data
+    int *clausulaInicio;
+    int *clausulaMembro;
+    int *choqueInicio;   //Grafo de choque em CSR, como em Data
+    int *choqueVizinho;
+    int disciplinas;
+    int numDisciplinasOp;
+    int *identificadorOb;
+    int *identificadorOp;
+    string *horario;
+    MascaraHorario *horarioBits;
+    unordered_map<string, int> indiceCodigo; //Código do SIGAA -> índice denso
+    char *imagem;         //Imagem mapeada de onde vêm os vetores (carregaCurriculo), ou NULL se alocados
+    size_t tamanhoImagem;
+};
+
+//O que muda de um aluno para outro no mesmo currículo
+struct EstadoAluno{
+    int *situacao;     //1 se concluída, 0 se pendente, por índice do currículo
+    int numCreditosOp; //Créditos de optativas que ainda faltam
+};
+
+//Métricas de uma resolução (metricas.cpp): tempo acumulado por fase, com o número de vezes que ela
+//rodou, e contadores do modelo e do Cbc. Cada resolução tem as suas, então nada é do processo todo
+struct TempoFase{
+    double segundos;
+    int chamadas;
+};
+
+struct Metricas{
+    unordered_map<string, TempoFase> temposFase;
+    unordered_map<string, double> contadores;
+};
+
+//Visão de um aluno usada pelo pré-processamento e pelos modelos (montaDados): os vetores do currículo
+//são apontados, não copiados, e só situacao pertence ao aluno
 struct Data{
     /*
      *  Disciplinas referentes aos identificadores
@@ -23,20 +103,110 @@ struct Data{
     string *nomeCadeira;
     int *creditos;
     int *preRequisito;
-    int **preReqI;
-    bool **choqueHorarioI;
+    int *preReqInicio;   //Pré-requisitos em CSR: cláusulas de i em preReqInicio[i] .. preReqInicio[i+1]-1, todas obrigatórias
+    int *clausulaInicio; //Disciplinas alternativas da cláusula c em clausulaMembro[clausulaInicio[c] .. clausulaInicio[c+1]-1]
+    int *clausulaMembro;
+    int *choqueInicio;   //Grafo de choque em CSR: vizinhos de i em choqueVizinho[choqueInicio[i] .. choqueInicio[i+1]-1]
+    int *choqueVizinho;
     int *situacao;
     int disciplinas;
     int numPeriodos;
     int numDisciplinasOp;
     int numCreditosOp;
+    int formulacaoChoque; //CHOQUE_PARES ou CHOQUE_SLOT
+    int formulacaoPeriodos; //PERIODOS_DESAGREGADO ou PERIODOS_AGREGADO
     int *identificadorOb;
     int *identificadorOp;
     string *horario;
+    MascaraHorario *horarioBits;
+    string prefixoSaida; //Prefixo dos arquivos gravados (grades, .lp e log), vazio no diretório atual
+    json *saidaMemoria;  //Se não for NULL, as grades vão para cá (chave: nome do arquivo) e nada é gravado
+    Metricas *metricas;  //Onde os tempos e contadores desta resolução são registrados, ou NULL para não medir
+    const Curriculo *curriculo;
+    Curriculo *curriculoProprio; //Currículo montado só para este aluno (liberado em destroiDados), ou NULL
+};
+
+//Formulações escolhidas na linha de comando (--choque e --periodos); sem elas valem as de montaDados
+struct Formulacao{
+    int choque;   //CHOQUE_PARES ou CHOQUE_SLOT
+    int periodos; //PERIODOS_DESAGREGADO ou PERIODOS_AGREGADO
+};
+
+//Horários lidos do horario.txt, compartilhados pelos alunos de um lote: chave no json (posição no
+//arquivo) e código do SIGAA de cada disciplina com horário
+struct Horarios{
+    vector<int> identificador;
+    vector<string> horario;
+};
+
+//Modelo montado uma única vez e resolvido nas duas etapas (Y e X)
+struct Modelo{
+    UFFProblem *prob;
+    Data *data;      //Aluno para o qual o modelo foi montado (lido pelo callback de heurística)
+    int *varX;       //Índice de X(i,j) no modelo em varX[i * numPeriodos + j], ou -1 se não existe
+    int varY;
+    int numPeriodos; //Períodos com que o modelo foi montado
+    double valorY;   //Y ótimo da primeira etapa, ou -1 se ainda não foi encontrado
+    int numColunas;
+    int *disciplinaColuna; //Disciplina e período de cada coluna X(i,j) do modelo (-1 na coluna de Y)
+    int *periodoColuna;
+    double *solucaoY; //Solução da primeira etapa por índice de coluna, ponto de partida da segunda
+    int maxY;           //Limite superior de Y usado para cortar as janelas de X; na segunda etapa, o Y fixado
+    int minY;           //Limite inferior de Y no modelo na etapa atual
+    int gulosoY;        //Y da grade gulosa, ou -1 se ela não coube
+    int *periodoGuloso; //Período de cada disciplina na grade gulosa (-1 se fora dela)
+};
+
+//Mede o tempo de uma fase do início ao fim do escopo e soma em metricas com registraTempo (nada é
+//registrado se metricas for NULL)
+struct CronometroFase{
+    CronometroFase(Metricas* metricas, const string& fase);
+    ~CronometroFase();
+    Metricas* metricas;
+    string fase;
+    chrono::steady_clock::time_point inicio;
 };
 
-extern void atualizaDados (Data *data);
-extern void solveCoin(Data *data);
-extern double solveCoin_Y(Data *data);
+extern MascaraHorario decodificaHorario(const string& codigo);
+extern void leHorarios(Horarios* horarios, const char* arquivo);
+extern void leCurriculo(Curriculo* curriculo, json& j, const Horarios* horarios);
+extern void leEstadoAluno(EstadoAluno* estado, const Curriculo* curriculo, json& j);
+extern void montaDados(Data* data, const Curriculo* curriculo, const EstadoAluno* estado);
+extern void atualizaDados(Data *data, const char* instancia = "instanciaNilbson.json", const Curriculo* curriculo = NULL,
+                          const Horarios* horarios = NULL);
+extern void atualizaDadosJson(Data *data, json& j, const Curriculo* curriculo = NULL, const Horarios* horarios = NULL);
+extern void destroiCurriculo(Curriculo* curriculo);
+extern bool gravaCurriculo(const Curriculo* curriculo, const char* arquivo);
+extern bool curriculoCompilado(const char* arquivo);
+extern bool carregaCurriculo(Curriculo* curriculo, const char* arquivo);
+extern void liberaImagemCurriculo(Curriculo* curriculo);
+extern bool abreCurriculo(Curriculo* curriculo, const char* arquivo);
+extern void destroiDados(Data *data);
+extern void calculaInicioMaisCedo(Data* data, int* inicio);
+extern int limiteInferiorY(Data* data);
+extern int escalonamentoGuloso(Data* data, int* periodo, const double* preferencia = NULL);
+extern void calculaJanelas(Data* data, int ultimoY, int* inicio, int* fim);
+extern void constroiModelo(Data *data, Modelo *modelo);
+extern void destroiModelo(Modelo *modelo);
+extern void solveCoin(Data *data, Modelo *modelo);
+extern void solveHeuristica(Data *data);
+extern void escreveGrade(Data* data, const int* periodo, const char* arquivo);
+extern bool solvePD(Data* data);
+extern double solveCoin_Y(Data *data, Modelo *modelo);
+extern void registraTempo(Metricas* metricas, const string& fase, double segundos);
+extern void registraContador(Metricas* metricas, const string& nome, double valor);
+extern void registraSolve(Metricas* metricas, const string& etapa, UFFProblem* prob);
+extern double tempoFase(const Metricas* metricas, const string& fase);
+extern void gravaMetricas(const Metricas* metricas, const char* arquivo);
+extern void resolveDados(Data* data, bool soHeuristica);
+extern void aplicaFormulacao(Data* data, const Formulacao* formulacao);
+extern void executaServidor(const char* caminho, int trabalhadores, const Curriculo* curriculo,
+                            const Formulacao* formulacao = NULL);
+extern void resolveAluno(const char* instancia, bool soHeuristica, const Curriculo* curriculo = NULL,
+                         const string& prefixoSaida = "", const Formulacao* formulacao = NULL,
+                         Metricas* metricas = NULL);
+extern void executaLote(const char* entrada, const char* diretorioSaida, int trabalhadores,
+                        const char* arquivoCurriculo = NULL, const Formulacao* formulacao = NULL);
+extern void executaBenchmark(int repeticoes);
 
 #endif
\ No newline at end of file
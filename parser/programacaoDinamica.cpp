@@ -0,0 +1,333 @@
+#include "parser.h"
+
+//SOLVER EXATO POR PROGRAMAÇÃO DINÂMICA
+//Para alunos com poucas disciplinas pendentes (até LIMITE_PD) a grade ótima sai de uma programação
+//dinâmica sobre o conjunto de pendentes já cursadas, guardado em bits. O estado é (período j, conjunto
+//S cursado antes de j) e cada transição cursa em j um conjunto T de disponíveis sem choque dentro do
+//limite de créditos. As duas etapas do MIP saem da mesma busca: o menor Y com grade viável e, nesse Y,
+//a grade de menor soma de períodos.
+
+//Cada disciplina cursada no período j custa j * PESO_PERIODO + 1: a soma dos períodos vem primeiro e,
+//no empate, a grade com menos disciplinas (nenhuma optativa a mais)
+#define PESO_PERIODO 64
+#define CUSTO_INVIAVEL 0x3fffffff
+
+typedef uint64_t Conjunto;
+
+static int contaBits(Conjunto x){
+    int n = 0;
+    for (; x; x &= x - 1)
+        n++;
+    return n;
+}
+
+struct ProgramacaoDinamica{
+    Data *data;
+    int m;                                //Pendentes, numeradas de 0 a m-1
+    vector<int> disciplina;               //Índice em Data de cada pendente
+    vector<int> creditos;
+    vector<Conjunto> choque;              //Pendentes que chocam com cada pendente
+    vector< vector<Conjunto> > clausulas; //Cláusulas de pré-requisito ainda não atendidas
+    vector<int> fim;                      //Último período possível de cada pendente com o Y atual
+    Conjunto obrigatorias, necessarias, optativas;
+    int maiorCreditoOp;                   //Maior número de créditos de uma optativa pendente
+    vector<Conjunto> cliques;             //Necessárias que ocupam um mesmo slot: uma por período
+    int ultimoY;
+    long long estados;                    //Estados calculados, para desistir de instâncias grandes
+    bool abortada;
+    unordered_map<uint64_t, pair<int, Conjunto> > memo; //Menor custo para terminar a partir de (j, S)
+                                                        //e o conjunto cursado em j para obtê-lo
+
+    //Transições de um estado, preenchidas na enumeração
+    struct Transicao{
+        int j;
+        Conjunto S;
+        vector<int> disponiveis;
+        vector<Conjunto> sufixo;     //Disponíveis a partir de cada posição
+        vector<int> sufixoCreditos;  //e a soma dos créditos delas
+        Conjunto necessariasDisponiveis;
+        int melhor;
+        Conjunto melhorT;
+    };
+
+    static uint64_t chave(int j, Conjunto S){
+        return ((uint64_t)j << 32) | S;
+    }
+
+    int creditosOptativas(Conjunto S){
+        int creditosOp = 0;
+        for (int k = 0; k < m; k++)
+            if (((S & optativas) >> k) & 1)
+                creditosOp += creditos[k];
+        return creditosOp;
+    }
+
+    //Terminou quando cursou todas as obrigatórias e os créditos de optativas
+    bool terminou(Conjunto S){
+        return !(obrigatorias & ~S) && creditosOptativas(S) >= data->numCreditosOp;
+    }
+
+    //Pendentes que ainda podem ajudar a terminar a partir de S: as necessárias, as optativas se faltam
+    //créditos e, em cadeia, as alternativas das cláusulas não atendidas dessas. Cursar outra só custa
+    Conjunto uteis(Conjunto S){
+        Conjunto U = necessarias;
+        if (creditosOptativas(S) < data->numCreditosOp)
+            U |= optativas;
+        U &= ~S;
+        for (Conjunto novas = U; novas;){
+            Conjunto mais = 0;
+            for (int k = 0; k < m; k++){
+                if (!((novas >> k) & 1))
+                    continue;
+                for (size_t q = 0; q < clausulas[k].size(); q++)
+                    if (!(clausulas[k][q] & S))
+                        mais |= clausulas[k][q];
+            }
+            novas = mais & ~U & ~S;
+            U |= novas;
+        }
+        return U;
+    }
+
+    //Enumera os conjuntos T a partir da disponível a (bloqueadas: as que chocam com alguma de T). T só
+    //vale se nenhuma necessária disponível ficou de fora podendo entrar (adiantá-la nunca piora a grade),
+    //então o ramo é cortado assim que uma necessária deixada não puder mais ser bloqueada por choque
+    //ou créditos com as disponíveis que restam
+    void enumera(Transicao& t, size_t a, Conjunto T, Conjunto bloqueadas, Conjunto deixadas, int cred){
+        if (abortada)
+            return;
+        for (Conjunto x = deixadas & ~bloqueadas; x; x &= x - 1){
+            int k = 0;
+            while (!((x >> k) & 1))
+                k++;
+            if (!(choque[k] & t.sufixo[a]) && cred + t.sufixoCreditos[a] + creditos[k] <= LIMITE_CREDITOS)
+                return;
+        }
+        if (a == t.disponiveis.size()){
+            //Cada necessária que fica para depois, e cada optativa que ainda falta para os créditos,
+            //custa pelo menos o próximo período
+            int agora = contaBits(T) * (t.j * PESO_PERIODO + 1);
+            int depois = contaBits(necessarias & ~(t.S | T));
+            int faltaOp = data->numCreditosOp - creditosOptativas(t.S | T);
+            if (faltaOp > 0)
+                depois += (faltaOp + maiorCreditoOp - 1) / maiorCreditoOp;
+            if (agora + depois * ((t.j + 1) * PESO_PERIODO + 1) >= t.melhor)
+                return;
+            int resto = resolve(t.j + 1, t.S | T);
+            if (resto >= CUSTO_INVIAVEL)
+                return;
+            int total = agora + resto;
+            if (total < t.melhor){
+                t.melhor = total;
+                t.melhorT = T;
+            }
+            return;
+        }
+        int k = t.disponiveis[a];
+        Conjunto bit = (Conjunto)1 << k;
+        if (!(bloqueadas & bit) && cred + creditos[k] <= LIMITE_CREDITOS)
+            enumera(t, a + 1, T | bit, bloqueadas | choque[k], deixadas, cred + creditos[k]);
+        enumera(t, a + 1, T, bloqueadas, deixadas | (t.necessariasDisponiveis & bit), cred);
+    }
+
+    //Cortes de viabilidade: janelas, créditos e cliques de slot das necessárias que faltam
+    bool viavel(int j, Conjunto S){
+        if (j > ultimoY)
+            return false;
+        int restantes = ultimoY - j + 1, creditosFaltam = 0;
+        for (int k = 0; k < m; k++){
+            if (((necessarias & ~S) >> k) & 1){
+                if (fim[k] < j)
+                    return false;
+                creditosFaltam += creditos[k];
+            }
+        }
+        if (creditosFaltam > restantes * LIMITE_CREDITOS)
+            return false;
+        for (size_t q = 0; q < cliques.size(); q++)
+            if (contaBits(cliques[q] & ~S) > restantes)
+                return false;
+        return true;
+    }
+
+    //Menor custo para completar o curso a partir do período j tendo cursado S
+    int resolve(int j, Conjunto S){
+        uint64_t c = chave(j, S);
+        unordered_map<uint64_t, pair<int, Conjunto> >::iterator it = memo.find(c);
+        if (it != memo.end())
+            return it->second.first;
+        if (++estados > LIMITE_ESTADOS_PD){
+            abortada = true;
+            return CUSTO_INVIAVEL;
+        }
+
+        Transicao t;
+        t.j = j;
+        t.S = S;
+        t.necessariasDisponiveis = 0;
+        t.melhor = CUSTO_INVIAVEL;
+        t.melhorT = 0;
+        if (terminou(S))
+            t.melhor = 0;
+        if (t.melhor == 0 || !viavel(j, S)){
+            memo[c] = make_pair(t.melhor, t.melhorT);
+            return t.melhor;
+        }
+
+        Conjunto U = uteis(S);
+        for (int k = 0; k < m; k++){
+            if (!((U >> k) & 1) || fim[k] < j)
+                continue;
+            bool disponivel = true;
+            for (size_t q = 0; q < clausulas[k].size() && disponivel; q++)
+                disponivel = (clausulas[k][q] & S) != 0;
+            if (!disponivel)
+                continue;
+            t.disponiveis.push_back(k);
+            if ((necessarias >> k) & 1)
+                t.necessariasDisponiveis |= (Conjunto)1 << k;
+        }
+        t.sufixo.assign(t.disponiveis.size() + 1, 0);
+        t.sufixoCreditos.assign(t.disponiveis.size() + 1, 0);
+        for (int a = (int)t.disponiveis.size() - 1; a >= 0; a--){
+            t.sufixo[a] = t.sufixo[a + 1] | ((Conjunto)1 << t.disponiveis[a]);
+            t.sufixoCreditos[a] = t.sufixoCreditos[a + 1] + creditos[t.disponiveis[a]];
+        }
+        enumera(t, 0, 0, 0, 0, 0);
+
+        memo[c] = make_pair(t.melhor, t.melhorT);
+        return t.melhor;
+    }
+};
+
+//Resolve as duas etapas por programação dinâmica e grava jSaidaY.json e jSaidaX.json como o MIP.
+//Retorna falso, sem gravar nada, se há pendentes demais, se a busca passou de LIMITE_ESTADOS_PD
+//estados ou se nenhum Y até o limite foi viável; nesses casos o chamador segue com o MIP, que também
+//é quem declara o aluno inviável
+bool solvePD(Data* data){
+    ProgramacaoDinamica pd;
+    pd.data = data;
+    pd.m = 0;
+    vector<int> indice(data->disciplinas, -1);
+    for (int i = 0; i < data->disciplinas; i++){
+        if (!data->situacao[i]){
+            indice[i] = pd.m++;
+            pd.disciplina.push_back(i);
+        }
+    }
+    if (pd.m > LIMITE_PD)
+        return false;
+    cout << "Disciplinas pendentes: " << pd.m << ", resolvendo por programacao dinamica" << endl;
+
+    pd.obrigatorias = pd.optativas = 0;
+    pd.maiorCreditoOp = 1;
+    pd.creditos.resize(pd.m);
+    pd.choque.assign(pd.m, 0);
+    pd.clausulas.resize(pd.m);
+    for (int k = 0; k < pd.m; k++){
+        int i = pd.disciplina[k];
+        pd.creditos[k] = data->creditos[i];
+        if (data->identificadorOb[i] != 0)
+            pd.obrigatorias |= (Conjunto)1 << k;
+        else if (data->identificadorOp[i] != 0){
+            pd.optativas |= (Conjunto)1 << k;
+            pd.maiorCreditoOp = max(pd.maiorCreditoOp, data->creditos[i]);
+        }
+        for (int v = data->choqueInicio[i]; v < data->choqueInicio[i + 1]; v++)
+            if (indice[data->choqueVizinho[v]] >= 0)
+                pd.choque[k] |= (Conjunto)1 << indice[data->choqueVizinho[v]];
+        for (int c = data->preReqInicio[i]; c < data->preReqInicio[i + 1]; c++){
+            Conjunto clausula = 0;
+            bool atendida = false;
+            for (int q = data->clausulaInicio[c]; q < data->clausulaInicio[c + 1]; q++){
+                int membro = data->clausulaMembro[q];
+                if (data->situacao[membro])
+                    atendida = true;
+                else
+                    clausula |= (Conjunto)1 << indice[membro];
+            }
+            if (!atendida)
+                pd.clausulas[k].push_back(clausula);
+        }
+    }
+
+    //Menor Y viável a partir do limite inferior. A janela de cada Y corta os estados sem saída
+    int *inicio = new int[data->disciplinas];
+    int *fim = new int[data->disciplinas];
+    int maxY = min(10, data->numPeriodos - 1);
+    int valorY = -1, valorX = 0;
+    long long estados = 0;
+    pd.fim.resize(pd.m);
+    for (int Y = limiteInferiorY(data); Y <= maxY && valorY < 0; Y++){
+        calculaJanelas(data, Y, inicio, fim);
+        pd.necessarias = pd.obrigatorias;
+        for (int k = 0; k < pd.m; k++){
+            pd.fim[k] = fim[pd.disciplina[k]];
+            if (pd.fim[k] < Y) //Janela encurtada: pré-requisito único de alguma que precisa ser cursada
+                pd.necessarias |= (Conjunto)1 << k;
+        }
+        pd.cliques.clear();
+        for (int t = 0; t < SLOTS_HORARIO; t++){
+            Conjunto clique = 0;
+            for (int k = 0; k < pd.m; k++)
+                if ((pd.necessarias >> k) & 1 && (data->horarioBits[pd.disciplina[k]].bits[t / 64] >> (t % 64)) & 1)
+                    clique |= (Conjunto)1 << k;
+            if (contaBits(clique) >= 2)
+                pd.cliques.push_back(clique);
+        }
+        pd.ultimoY = Y;
+        pd.estados = 0;
+        pd.abortada = false;
+        pd.memo.clear();
+        int total = pd.resolve(0, 0);
+        estados += pd.estados;
+        registraContador(data->metricas, "programacaoDinamica.estados", estados);
+        if (pd.abortada){
+            cout << "Programacao dinamica passou de " << LIMITE_ESTADOS_PD << " estados, usando o MIP" << endl;
+            delete[] inicio;
+            delete[] fim;
+            return false;
+        }
+        if (total < CUSTO_INVIAVEL){
+            valorY = Y;
+            valorX = total / PESO_PERIODO;
+        }
+    }
+    delete[] inicio;
+    delete[] fim;
+
+    if (valorY < 0){
+        cout << "Programacao dinamica nao achou Y viavel ate " << maxY << ", usando o MIP" << endl;
+        return false;
+    }
+
+    //Refaz o caminho ótimo a partir do estado inicial
+    int *periodo = new int[data->disciplinas];
+    for (int i = 0; i < data->disciplinas; i++)
+        periodo[i] = -1;
+    Conjunto S = 0;
+    for (int j = 0; !pd.terminou(S); j++){
+        Conjunto T = pd.memo[ProgramacaoDinamica::chave(j, S)].second;
+        for (int k = 0; k < pd.m; k++)
+            if ((T >> k) & 1)
+                periodo[pd.disciplina[k]] = j;
+        S |= T;
+    }
+
+    //Mesma saída das duas etapas do MIP; a grade ótima da segunda também serve de grade da primeira
+    cout << "Solucao otima encontrada!" << endl << endl;
+    cout << "Solucao:" << endl;
+    cout << setw(4) << "Valor da funcao objetivo = " << valorY << endl;
+    data->numPeriodos = valorY + 1;
+    escreveGrade(data, periodo, "jSaidaY.json");
+    cout << endl;
+
+    cout << "Solucao otima encontrada!" << endl << endl;
+    cout << "Solucao:" << endl;
+    cout << "Valor da funcao objetivo = " << valorX << endl;
+    escreveGrade(data, periodo, "jSaidaX.json");
+    cout << endl;
+
+    delete[] periodo;
+    return true;
+}
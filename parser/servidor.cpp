@@ -0,0 +1,162 @@
+#include "parser.h"
+#ifdef __LINUX__
+#include <cerrno>
+#include <csignal>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#endif
+
+//SERVIDOR (--serve SOCKET)
+//Atende alunos num socket Unix com o currículo já carregado. Cada linha recebida é uma instância do
+//aluno em json (como os arquivos instancia*.json; basta "situacao" e "codigo") e cada resposta é uma
+//linha {"X": grade, "Y": grade} com o conteúdo de jSaidaX.json e jSaidaY.json, ou {"erro": mensagem}.
+//Um "id" no pedido volta na resposta. Cada conexão é atendida por um processo filho, no máximo
+//--workers ao mesmo tempo; as demais esperam na fila do listen. Como no lote, processos e não threads:
+//o uso concorrente do Cbc não foi verificado, e cout e stdout são do processo todo
+
+#define FILA_CONEXOES 64
+
+//Resolve um pedido e monta a linha de resposta (sem o '\n')
+static string atendePedido(const string& linha, const Curriculo* curriculo, const Formulacao* formulacao){
+    json resposta;
+    ostringstream descarte; //A saída do solver não vai para o cliente
+    streambuf* saidaOriginal = cout.rdbuf(descarte.rdbuf());
+    try{
+        json pedido = json::parse(linha);
+        if (pedido.is_object() && pedido.find("id") != pedido.end())
+            resposta["id"] = pedido["id"];
+        Data data;
+        json grades;
+        atualizaDadosJson(&data, pedido, curriculo);
+        data.saidaMemoria = &grades;
+        aplicaFormulacao(&data, formulacao);
+        resolveDados(&data, false);
+        json::const_iterator gradeX = grades.find("jSaidaX.json"), gradeY = grades.find("jSaidaY.json");
+        if (gradeX != grades.end() && gradeY != grades.end()){
+            resposta["X"] = *gradeX;
+            resposta["Y"] = *gradeY;
+        }else{
+            resposta["erro"] = "Nao foi encontrada uma solucao otima";
+        }
+    }catch (const exception& e){
+        resposta["erro"] = e.what();
+    }
+    cout.rdbuf(saidaOriginal);
+    return resposta.dump();
+}
+
+#ifdef __LINUX__
+//Remove o arquivo do caminho só se ele for um socket (deixado por uma execução anterior). Retorna falso
+//se lá existe outra coisa, que nunca é apagada
+static bool removeSocketAntigo(const char* caminho){
+    struct stat info;
+    if (lstat(caminho, &info) != 0)
+        return errno == ENOENT;
+    if (!S_ISSOCK(info.st_mode))
+        return false;
+    return unlink(caminho) == 0;
+}
+
+//Escreve tudo, repetindo em escritas parciais. Retorna falso se o cliente fechou a conexão
+static bool escreveTudo(int fd, const string& texto){
+    size_t enviado = 0;
+    while (enviado < texto.size()){
+        ssize_t n = write(fd, texto.data() + enviado, texto.size() - enviado);
+        if (n < 0 && errno == EINTR)
+            continue;
+        if (n <= 0)
+            return false;
+        enviado += n;
+    }
+    return true;
+}
+
+//Lê os pedidos do cliente, uma linha por vez, até ele fechar a conexão
+static void atendeCliente(int cliente, const Curriculo* curriculo, const Formulacao* formulacao){
+    string pendente;
+    char buffer[65536];
+    for (;;){
+        ssize_t n = read(cliente, buffer, sizeof(buffer));
+        if (n < 0 && errno == EINTR)
+            continue;
+        if (n <= 0)
+            break;
+        pendente.append(buffer, n);
+        size_t fim;
+        while ((fim = pendente.find('\n')) != string::npos){
+            string linha = pendente.substr(0, fim);
+            pendente.erase(0, fim + 1);
+            if (linha.find_first_not_of(" \t\r") == string::npos)
+                continue;
+            if (!escreveTudo(cliente, atendePedido(linha, curriculo, formulacao) + "\n"))
+                return;
+        }
+    }
+    //Último pedido sem '\n' antes de fechar a escrita
+    if (pendente.find_first_not_of(" \t\r") != string::npos)
+        escreveTudo(cliente, atendePedido(pendente, curriculo, formulacao) + "\n");
+}
+#endif
+
+void executaServidor(const char* caminho, int trabalhadores, const Curriculo* curriculo, const Formulacao* formulacao){
+#ifdef __LINUX__
+    struct sockaddr_un endereco;
+    memset(&endereco, 0, sizeof(endereco));
+    endereco.sun_family = AF_UNIX;
+    if (strlen(caminho) >= sizeof(endereco.sun_path)){
+        cout << "Caminho do socket longo demais: " << caminho << endl;
+        return;
+    }
+    strcpy(endereco.sun_path, caminho);
+
+    int servidor = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (servidor < 0 || !removeSocketAntigo(caminho) || bind(servidor, (struct sockaddr*)&endereco, sizeof(endereco)) < 0 ||
+        listen(servidor, FILA_CONEXOES) < 0){
+        cout << "Nao foi possivel abrir o socket " << caminho << endl;
+        if (servidor >= 0)
+            close(servidor);
+        return;
+    }
+    signal(SIGPIPE, SIG_IGN); //Cliente que fecha antes da resposta não derruba o processo
+    cout << "Atendendo em " << caminho << " com ate " << trabalhadores << " processos" << endl;
+
+    int ativos = 0;
+    for (;;){
+        //Recolhe os filhos que terminaram e, com todos ocupados, espera um deles
+        while (ativos > 0 && waitpid(-1, NULL, WNOHANG) > 0)
+            ativos--;
+        while (ativos >= trabalhadores && waitpid(-1, NULL, 0) > 0)
+            ativos--;
+
+        int cliente = accept(servidor, NULL, NULL);
+        if (cliente < 0){
+            if (errno == EINTR || errno == ECONNABORTED)
+                continue;
+            break;
+        }
+        cout.flush();
+        pid_t pid = fork();
+        if (pid == 0){
+            close(servidor);
+            atendeCliente(cliente, curriculo, formulacao);
+            close(cliente);
+            _exit(0);
+        }
+        if (pid > 0)
+            ativos++;
+        else //Sem processo novo: atende aqui mesmo
+            atendeCliente(cliente, curriculo, formulacao);
+        close(cliente);
+    }
+    close(servidor);
+    removeSocketAntigo(caminho);
+#else
+    (void)trabalhadores;
+    (void)curriculo;
+    (void)formulacao;
+    cout << "Modo servidor disponivel apenas no Linux: " << caminho << endl;
+#endif
+}